@@ -34,14 +34,20 @@
 #include "src/ik_effector_3d.h"
 #include "src/ik_effector_template_3d.h"
 #include "src/ik_kusudama_3d.h"
+#include "src/ik_ray_3d.h"
+#include "src/ik_solve_server_3d.h"
 #include "src/many_bone_ik_3d.h"
+#include "src/math/ik_transform_store_3d.h"
 
 #ifdef TOOLS_ENABLED
 #include "editor/many_bone_ik_3d_gizmo_plugin.h"
 #endif
 
+static IKSolveServer3D *ik_solve_server = nullptr;
+
 void initialize_many_bone_ik_module(ModuleInitializationLevel p_level) {
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+		ik_solve_server = memnew(IKSolveServer3D);
 	}
 #ifdef TOOLS_ENABLED
 	if (p_level == MODULE_INITIALIZATION_LEVEL_EDITOR) {
@@ -53,6 +59,7 @@ void initialize_many_bone_ik_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(ManyBoneIK3D);
 		GDREGISTER_CLASS(IKBone3D);
 		GDREGISTER_CLASS(IKNode3D);
+		GDREGISTER_INTERNAL_CLASS(IKTransformStore3D);
 		GDREGISTER_CLASS(IKEffector3D);
 		GDREGISTER_CLASS(IKBoneSegment3D);
 		GDREGISTER_CLASS(IKKusudama3D);
@@ -65,4 +72,8 @@ void uninitialize_many_bone_ik_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+	if (ik_solve_server) {
+		memdelete(ik_solve_server);
+		ik_solve_server = nullptr;
+	}
 }
@@ -135,14 +135,30 @@ Ref<IKEffector3D> IKBone3D::get_pin() const {
 }
 
 void IKBone3D::set_pose(const Transform3D &p_transform) {
+	if (transform_store.is_valid()) {
+		transform_store->set_transform(aligned_handle, p_transform);
+		return;
+	}
 	godot_skeleton_aligned_transform->set_transform(p_transform);
 }
 
 Transform3D IKBone3D::get_pose() const {
+	if (transform_store.is_valid()) {
+		return transform_store->get_transform(aligned_handle);
+	}
 	return godot_skeleton_aligned_transform->get_transform();
 }
 
 void IKBone3D::set_global_pose(const Transform3D &p_transform) {
+	if (transform_store.is_valid()) {
+		transform_store->set_global_transform(aligned_handle, p_transform);
+		if (constraint_orientation_handle != -1) {
+			Transform3D transform = transform_store->get_transform(constraint_orientation_handle);
+			transform.origin = transform_store->get_transform(aligned_handle).origin;
+			transform_store->set_transform(constraint_orientation_handle, transform);
+		}
+		return;
+	}
 	godot_skeleton_aligned_transform->set_global_transform(p_transform);
 	Transform3D transform = constraint_orientation_transform->get_transform();
 	transform.origin = godot_skeleton_aligned_transform->get_transform().origin;
@@ -151,10 +167,16 @@ void IKBone3D::set_global_pose(const Transform3D &p_transform) {
 }
 
 Transform3D IKBone3D::get_global_pose() const {
+	if (transform_store.is_valid()) {
+		return transform_store->get_global_transform(aligned_handle);
+	}
 	return godot_skeleton_aligned_transform->get_global_transform();
 }
 
 Transform3D IKBone3D::get_bone_direction_global_pose() const {
+	if (transform_store.is_valid()) {
+		return transform_store->get_global_transform(bone_direction_handle);
+	}
 	return bone_direction_transform->get_global_transform();
 }
 
@@ -199,8 +221,6 @@ IKBone3D::IKBone3D(StringName p_bone, Skeleton3D *p_skeleton, const Ref<IKBone3D
 		ManyBoneIK3D *p_many_bone_ik) {
 	ERR_FAIL_NULL(p_skeleton);
 
-	default_dampening = p_default_dampening;
-	cos_half_dampen = cos(default_dampening / real_t(2.0));
 	set_name(p_bone);
 	bone_id = p_skeleton->find_bone(p_bone);
 	if (p_parent.is_valid()) {
@@ -214,23 +234,40 @@ IKBone3D::IKBone3D(StringName p_bone, Skeleton3D *p_skeleton, const Ref<IKBone3D
 			create_pin();
 			Ref<IKEffector3D> effector = get_pin();
 			effector->set_target_node(p_skeleton, elem->get_target_node());
+			effector->set_target_static(elem->is_target_static());
+			if (elem->is_target_transform_fed()) {
+				effector->set_target_transform(elem->get_target_transform());
+			}
 			effector->set_motion_propagation_factor(elem->get_motion_propagation_factor());
 			effector->set_weight(elem->get_weight());
+			effector->set_blend_weight(elem->get_blend_weight());
+			effector->set_weight_falloff_curve(elem->get_weight_falloff_curve());
+			effector->set_weight_falloff_distance(elem->get_weight_falloff_distance());
 			effector->set_direction_priorities(elem->get_direction_priorities());
 			break;
 		}
 	}
 	bone_direction_transform->set_parent(godot_skeleton_aligned_transform);
 
-	float predamp = 1.0 - get_stiffness();
-	dampening = get_parent().is_null() ? Math_PI : predamp * p_default_dampening;
-	float iterations = p_many_bone_ik->get_iterations_per_frame();
 	if (get_constraint().is_null()) {
 		Ref<IKKusudama3D> new_constraint;
 		new_constraint.instantiate();
 		add_constraint(new_constraint);
 	}
-	float returnfulness = get_constraint()->get_resistance();
+	update_dampening(p_default_dampening, p_many_bone_ik->get_iterations_per_frame());
+}
+
+void IKBone3D::update_dampening(float p_default_dampening, float p_iterations) {
+	default_dampening = p_default_dampening;
+	cos_half_dampen = cos(default_dampening / real_t(2.0));
+	float predamp = 1.0 - get_stiffness();
+	dampening = get_parent().is_null() ? Math_PI : predamp * default_dampening;
+	update_returnfulness(p_iterations);
+}
+
+void IKBone3D::update_returnfulness(float p_iterations) {
+	float iterations = p_iterations;
+	float returnfulness = get_constraint().is_valid() ? get_constraint()->get_resistance() : 0.0f;
 	float falloff = 0.2f;
 	half_returnfulness_dampened.resize(iterations);
 	cos_half_returnfulness_dampened.resize(iterations);
@@ -264,6 +301,66 @@ Ref<IKNode3D> IKBone3D::get_ik_transform() {
 	return godot_skeleton_aligned_transform;
 }
 
+void IKBone3D::_bind_constraint_transforms(const Ref<IKTransformStore3D> &p_store, int32_t p_parent_handle) {
+	constraint_orientation_handle = p_store->add_node(p_parent_handle);
+	constraint_orientation_transform->bind_to_store(p_store, constraint_orientation_handle);
+	constraint_twist_handle = p_store->add_node(p_parent_handle);
+	constraint_twist_transform->bind_to_store(p_store, constraint_twist_handle);
+}
+
+void IKBone3D::bind_transform_store(const Ref<IKTransformStore3D> &p_store, int32_t p_parent_handle) {
+	ERR_FAIL_COND(p_store.is_null());
+	transform_store = p_store;
+	aligned_handle = p_store->add_node(p_parent_handle);
+	godot_skeleton_aligned_transform->bind_to_store(p_store, aligned_handle);
+	bone_direction_handle = p_store->add_node(aligned_handle);
+	bone_direction_transform->bind_to_store(p_store, bone_direction_handle);
+	for (Ref<IKBone3D> &child : children) {
+		child->_bind_constraint_transforms(p_store, aligned_handle);
+		child->bind_transform_store(p_store, aligned_handle);
+	}
+	if (parent.is_null()) {
+		// The root bone's constraint frames have no parent, like their unbound nodes.
+		// They are appended last so they do not split the depth-first ranges above.
+		_bind_constraint_transforms(p_store, -1);
+	}
+}
+
+IKTransformStore3D *IKBone3D::get_transform_store() const {
+	return transform_store.ptr();
+}
+
+int32_t IKBone3D::get_ik_transform_handle() const {
+	return aligned_handle;
+}
+
+int32_t IKBone3D::get_bone_direction_handle() const {
+	return bone_direction_handle;
+}
+
+int32_t IKBone3D::get_constraint_orientation_handle() const {
+	return constraint_orientation_handle;
+}
+
+int32_t IKBone3D::get_constraint_twist_handle() const {
+	return constraint_twist_handle;
+}
+
+bool IKBone3D::update_constraint_frames() {
+	if (constraint.is_null() || transform_store.is_null() || parent.is_null()) {
+		return false;
+	}
+	if (constraint_orientation_handle == -1 || constraint_twist_handle == -1) {
+		return false;
+	}
+	constraint->compute_constraint_frames(transform_store.ptr(), aligned_handle, constraint_orientation_handle, constraint_twist_handle, constraint_frames);
+	return true;
+}
+
+const IKConstraintFrames3D &IKBone3D::get_constraint_frames() const {
+	return constraint_frames;
+}
+
 Ref<IKNode3D> IKBone3D::get_constraint_orientation_transform() {
 	return constraint_orientation_transform;
 }
@@ -71,6 +71,17 @@ class IKBone3D : public Resource {
 	Ref<IKNode3D> godot_skeleton_aligned_transform = Ref<IKNode3D>(memnew(IKNode3D())); // The bone's actual transform.
 	Ref<IKNode3D> bone_direction_transform = Ref<IKNode3D>(memnew(IKNode3D())); // Physical direction of the bone. Calculate Y is the bone up.
 
+	// Handles of the four nodes above in the segment tree's transform store, once bound.
+	Ref<IKTransformStore3D> transform_store;
+	int32_t aligned_handle = -1;
+	int32_t bone_direction_handle = -1;
+	int32_t constraint_orientation_handle = -1;
+	int32_t constraint_twist_handle = -1;
+	// The constraint's global limiting frames, refreshed once per bone update by update_constraint_frames().
+	IKConstraintFrames3D constraint_frames;
+
+	void _bind_constraint_transforms(const Ref<IKTransformStore3D> &p_store, int32_t p_parent_handle);
+
 protected:
 	static void _bind_methods();
 
@@ -108,9 +119,20 @@ public:
 	void create_pin();
 	bool is_pinned() const;
 	Ref<IKNode3D> get_ik_transform();
+	void bind_transform_store(const Ref<IKTransformStore3D> &p_store, int32_t p_parent_handle);
+	IKTransformStore3D *get_transform_store() const;
+	int32_t get_ik_transform_handle() const;
+	int32_t get_bone_direction_handle() const;
+	int32_t get_constraint_orientation_handle() const;
+	int32_t get_constraint_twist_handle() const;
+	bool update_constraint_frames();
+	const IKConstraintFrames3D &get_constraint_frames() const;
 	IKBone3D() {}
 	IKBone3D(StringName p_bone, Skeleton3D *p_skeleton, const Ref<IKBone3D> &p_parent, Vector<Ref<IKEffectorTemplate3D>> &p_pins, float p_default_dampening = Math_PI, ManyBoneIK3D *p_many_bone_ik = nullptr);
 	~IKBone3D() {}
+	void update_dampening(float p_default_dampening, float p_iterations);
+	// Rebuilds the per-iteration tables of how far the constraint's resistance pulls the bone back toward its comfort region.
+	void update_returnfulness(float p_iterations);
 	float get_cos_half_dampen() const;
 	void set_cos_half_dampen(float p_cos_half_dampen);
 	Transform3D get_parent_bone_aligned_transform();
@@ -30,6 +30,7 @@
 
 #include "ik_bone_segment_3d.h"
 
+#include "core/os/os.h"
 #include "core/string/string_builder.h"
 #include "ik_effector_3d.h"
 #include "ik_kusudama_3d.h"
@@ -71,7 +72,28 @@ void IKBoneSegment3D::create_bone_list(Vector<Ref<IKBone3D>> &p_list, bool p_rec
 	p_list.append_array(list);
 }
 
+void IKBoneSegment3D::fill_constraint_batch(IKConstraintBatch3D &r_batch, bool p_recursive) const {
+	if (p_recursive) {
+		for (const Ref<IKBoneSegment3D> &child : child_segments) {
+			if (child.is_valid()) {
+				child->fill_constraint_batch(r_batch, p_recursive);
+			}
+		}
+	}
+	for (const Ref<IKBone3D> &bone : bones) {
+		if (bone.is_null() || bone->get_parent().is_null()) {
+			continue;
+		}
+		const Ref<IKKusudama3D> &constraint = bone->get_constraint();
+		if (constraint.is_null() || (!constraint->is_orientationally_constrained() && !constraint->is_axially_constrained())) {
+			continue;
+		}
+		r_batch.add_lane(bone->get_bone_id(), constraint.ptr());
+	}
+}
+
 void IKBoneSegment3D::update_pinned_list(Vector<Vector<double>> &r_weights) {
+	effector_list.clear();
 	for (int32_t chain_i = 0; chain_i < child_segments.size(); chain_i++) {
 		Ref<IKBoneSegment3D> chain = child_segments[chain_i];
 		chain->update_pinned_list(r_weights);
@@ -89,9 +111,7 @@ void IKBoneSegment3D::update_pinned_list(Vector<Vector<double>> &r_weights) {
 
 void IKBoneSegment3D::_update_optimal_rotation(Ref<IKBone3D> p_for_bone, double p_damp, bool p_translate, bool p_constraint_mode, int32_t current_iteration, int32_t total_iterations) {
 	ERR_FAIL_COND(p_for_bone.is_null());
-	_update_target_headings(p_for_bone, &heading_weights, &target_headings);
-	_update_tip_headings(p_for_bone, &tip_headings);
-	_set_optimal_rotation(p_for_bone, &tip_headings, &target_headings, &heading_weights, p_damp, p_translate, p_constraint_mode);
+	_set_optimal_rotation(p_for_bone, &tip_headings, &target_headings, &heading_weights, p_damp, p_translate, p_constraint_mode, current_iteration, total_iterations);
 }
 
 Quaternion IKBoneSegment3D::clamp_to_cos_half_angle(Quaternion p_quat, double p_cos_half_angle) {
@@ -111,17 +131,22 @@ Quaternion IKBoneSegment3D::clamp_to_cos_half_angle(Quaternion p_quat, double p_
 	return p_quat;
 }
 
-float IKBoneSegment3D::_get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights) {
-	float manual_RMSD = 0.0f;
-	float w_sum = 0.0f;
+double IKBoneSegment3D::_get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights) {
+	// Accumulated in double like the weights, so the stabilization comparisons do not depend on the solver precision.
+	double manual_RMSD = 0.0;
+	double w_sum = 0.0;
 	for (int i = 0; i < r_htarget.size(); i++) {
-		float x_d = r_htarget[i].x - r_htip[i].x;
-		float y_d = r_htarget[i].y - r_htip[i].y;
-		float z_d = r_htarget[i].z - r_htip[i].z;
-		float mag_sq = p_weights[i] * (x_d * x_d + y_d * y_d + z_d * z_d);
+		double x_d = r_htarget[i].x - r_htip[i].x;
+		double y_d = r_htarget[i].y - r_htip[i].y;
+		double z_d = r_htarget[i].z - r_htip[i].z;
+		double mag_sq = p_weights[i] * (x_d * x_d + y_d * y_d + z_d * z_d);
 		manual_RMSD += mag_sq;
 		w_sum += p_weights[i];
 	}
+	// Every pin faded out; there is nothing to get closer to.
+	if (w_sum <= 0.0) {
+		return 0.0;
+	}
 	manual_RMSD /= w_sum * w_sum;
 	return manual_RMSD;
 }
@@ -132,34 +157,61 @@ void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVect
 	ERR_FAIL_NULL(r_htarget);
 	ERR_FAIL_NULL(r_weights);
 
-	_update_target_headings(p_for_bone, &heading_weights, &target_headings);
-	Transform3D prev_transform = p_for_bone->get_pose();
+	IKTransformStore3D *store = p_for_bone->get_transform_store();
+	ERR_FAIL_NULL(store);
+	const int32_t bone_handle = p_for_bone->get_ik_transform_handle();
+
+	_update_target_headings(p_for_bone, &heading_base_weights, &target_headings);
+	_begin_tip_frames_motion(store, bone_handle);
+	Transform3D prev_transform = store->get_transform(bone_handle);
 	bool got_closer = true;
 	double bone_damp = p_for_bone->get_cos_half_dampen();
+	// The parent is final by now, so the limiting frames hold for every pass below.
+	bool is_constrained = p_for_bone->update_constraint_frames();
+	// How far the constraint's resistance pulls the bone back this iteration, from the bone's precomputed tables.
+	double resistance_angle = 0.0;
+	double cos_half_resistance_angle = 1.0;
+	const int32_t resistance_iteration = current_iteration;
+	const Vector<float> &resistance_angles = p_for_bone->get_half_returnfullness_dampened();
+	if (is_constrained && !p_constraint_mode && resistance_iteration >= 0 && resistance_iteration < resistance_angles.size()) {
+		resistance_angle = resistance_angles[resistance_iteration];
+		cos_half_resistance_angle = p_for_bone->get_cos_half_returnfullness_dampened()[resistance_iteration];
+	}
+	bool is_resisted = resistance_angle > 0.0;
 	int i = 0;
 	do {
 		_update_tip_headings(p_for_bone, &tip_headings);
 		if (!p_constraint_mode) {
-			Array superpose_result = QuaternionCharacteristicPolynomial::weighted_superpose(*r_htip, *r_htarget, *r_weights, p_translate, evec_prec);
-			Quaternion rotation = superpose_result[0];
-			Vector3 translation = superpose_result[1];
+			Quaternion rotation;
+			Vector3 translation;
+#ifdef DEBUG_ENABLED
+			uint64_t qcp_begin = OS::get_singleton()->get_ticks_usec();
+#endif
+			qcp_solver.weighted_superpose(r_htip->ptr(), r_htarget->ptr(), r_weights->is_empty() ? nullptr : r_weights->ptr(), r_htip->size(), p_translate, rotation, translation);
+#ifdef DEBUG_ENABLED
+			solver_stats.qcp_usec += OS::get_singleton()->get_ticks_usec() - qcp_begin;
+#endif
 			double dampening = (p_dampening != -1.0) ? p_dampening : bone_damp;
 			rotation = clamp_to_cos_half_angle(rotation, cos(dampening / 2.0));
-			if (current_iteration == 0) {
-				current_iteration = 0.0001;
-			}
-			rotation = rotation.slerp(p_for_bone->get_global_pose().basis, static_cast<double>(total_iterations) / current_iteration);
-			p_for_bone->get_ik_transform()->rotate_local_with_global(rotation);
-			Transform3D result = Transform3D(p_for_bone->get_global_pose().basis, p_for_bone->get_global_pose().origin + translation);
-			p_for_bone->set_global_pose(result);
+			store->rotate_local_with_global(bone_handle, rotation);
+			const Transform3D &global_pose = store->get_global_transform(bone_handle);
+			p_for_bone->set_global_pose(Transform3D(global_pose.basis, global_pose.origin + translation));
 		}
-		bool is_parent_valid = p_for_bone->get_parent().is_valid();
-		if (is_parent_valid && p_for_bone->is_orientationally_constrained()) {
-			p_for_bone->get_constraint()->snap_to_orientation_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_orientation_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
+#ifdef DEBUG_ENABLED
+		uint64_t snap_begin = OS::get_singleton()->get_ticks_usec();
+#endif
+		[[maybe_unused]] uint32_t snap_count = 0;
+		if (is_resisted) {
+			// Soft limit first, so the hard limits below always have the last word.
+			snap_count += p_for_bone->get_constraint()->apply_resistance(store, p_for_bone->get_bone_direction_handle(), bone_handle, p_for_bone->get_constraint_frames(), resistance_angle, cos_half_resistance_angle);
 		}
-		if (is_parent_valid && p_for_bone->is_axially_constrained()) {
-			p_for_bone->get_constraint()->set_snap_to_twist_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_twist_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
+		if (is_constrained) {
+			snap_count += p_for_bone->get_constraint()->apply_limits(store, p_for_bone->get_bone_direction_handle(), bone_handle, p_for_bone->get_constraint_frames());
 		}
+#ifdef DEBUG_ENABLED
+		solver_stats.snap_usec += OS::get_singleton()->get_ticks_usec() - snap_begin;
+		solver_stats.constraint_snaps += snap_count;
+#endif
 		if (default_stabilizing_pass_count > 0) {
 			_update_tip_headings(p_for_bone, &tip_headings_uniform);
 			double current_msd = _get_manual_msd(tip_headings_uniform, target_headings, heading_weights);
@@ -169,50 +221,232 @@ void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVect
 				break;
 			} else {
 				got_closer = false;
-				p_for_bone->set_pose(prev_transform);
+				store->set_transform(bone_handle, prev_transform);
+#ifdef DEBUG_ENABLED
+				solver_stats.stabilization_rollbacks++;
+#endif
 			}
 		}
 		i++;
 	} while (i < default_stabilizing_pass_count && !got_closer);
+	_commit_tip_frames_motion(store);
 
 	if (root == p_for_bone) {
 		previous_deviation = INFINITY;
 	}
 }
 
+double IKBoneSegment3D::compute_heading_error() {
+	if (root.is_null() || heading_weights.is_empty()) {
+		return 0.0;
+	}
+	// Both heading sets are rebuilt before every use in _set_optimal_rotation, so they can be borrowed here.
+	_update_target_headings(root, &heading_base_weights, &target_headings);
+	_refresh_tip_frames();
+	_update_tip_headings(root, &tip_headings_uniform);
+	double error = _get_manual_msd(tip_headings_uniform, target_headings, heading_weights);
+	return Math::is_finite(error) ? error : 0.0;
+}
+
+#ifdef DEBUG_ENABLED
+void IKBoneSegment3D::reset_solver_stats() {
+	solver_stats = SolverStats();
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		child->reset_solver_stats();
+	}
+}
+
+void IKBoneSegment3D::accumulate_solver_stats(SolverStats &r_stats) const {
+	r_stats.solve_usec += solver_stats.solve_usec;
+	r_stats.qcp_usec += solver_stats.qcp_usec;
+	r_stats.snap_usec += solver_stats.snap_usec;
+	r_stats.stabilization_rollbacks += solver_stats.stabilization_rollbacks;
+	r_stats.constraint_snaps += solver_stats.constraint_snaps;
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		child->accumulate_solver_stats(r_stats);
+	}
+}
+#endif
+
+void IKBoneSegment3D::set_last_solve_result(int32_t p_iteration_count, double p_error) {
+	last_iteration_count = p_iteration_count;
+	last_error = p_error;
+}
+
+int32_t IKBoneSegment3D::get_last_iteration_count() const {
+	return last_iteration_count;
+}
+
+double IKBoneSegment3D::get_last_error() const {
+	return last_error;
+}
+
+void IKBoneSegment3D::set_solver_precision(QCPSolver::ScalarPrecision p_precision) {
+	qcp_solver.set_scalar_precision(p_precision);
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		if (child.is_valid()) {
+			child->set_solver_precision(p_precision);
+		}
+	}
+}
+
+QCPSolver::ScalarPrecision IKBoneSegment3D::get_solver_precision() const {
+	return qcp_solver.get_scalar_precision();
+}
+
+void IKBoneSegment3D::_update_target_heading_points() {
+	// Targets only move between frames, and static targets not at all, so the points are rebuilt only for effectors whose target changed.
+	if (effector_target_versions.size() != uint32_t(effector_list.size())) {
+		effector_target_versions.resize(effector_list.size());
+		for (uint32_t &version : effector_target_versions) {
+			version = 0;
+		}
+	}
+	Vector3 *points = target_heading_points.ptrw();
+	const double *weights = heading_base_weights.ptr();
+	int32_t last_index = 0;
+	for (int32_t effector_i = 0; effector_i < effector_list.size(); effector_i++) {
+		const Ref<IKEffector3D> &effector = effector_list[effector_i];
+		if (effector.is_null()) {
+			continue;
+		}
+		uint32_t version = effector->get_target_version();
+		if (effector_target_versions[effector_i] == version) {
+			last_index += effector->get_target_heading_count();
+			continue;
+		}
+		last_index = effector->update_effector_target_points(points, last_index, weights);
+		effector_target_versions[effector_i] = version;
+	}
+}
+
 void IKBoneSegment3D::_update_target_headings(Ref<IKBone3D> p_for_bone, Vector<double> *r_weights, PackedVector3Array *r_target_headings) {
 	ERR_FAIL_COND(p_for_bone.is_null());
 	ERR_FAIL_NULL(r_weights);
 	ERR_FAIL_NULL(r_target_headings);
+	_update_target_heading_points();
+	const Vector3 *points = target_heading_points.ptr();
+	Vector3 *headings = r_target_headings->ptrw();
+	const double *weights = r_weights->ptr();
+	int32_t last_index = 0;
+	for (int32_t effector_i = 0; effector_i < effector_list.size(); effector_i++) {
+		const Ref<IKEffector3D> &effector = effector_list[effector_i];
+		if (effector.is_null()) {
+			continue;
+		}
+		last_index = effector->recenter_target_headings(points, headings, last_index, weights);
+	}
+}
+
+void IKBoneSegment3D::_refresh_tip_frames() {
+	effector_tip_frames.resize(effector_list.size());
+	for (int32_t effector_i = 0; effector_i < effector_list.size(); effector_i++) {
+		const Ref<IKEffector3D> &effector = effector_list[effector_i];
+		if (effector.is_valid()) {
+			effector_tip_frames[effector_i] = effector->get_ik_bone_3d()->get_bone_direction_global_pose();
+		}
+	}
+	tip_frames_bone_handle = -1;
+}
+
+bool IKBoneSegment3D::_update_heading_weights() {
+	// Rescales the weights in place, so fading pins in and out never reshapes or reallocates the heading arrays.
+	bool has_weight = false;
+	double *weights = heading_weights.ptrw();
+	const double *base_weights = heading_base_weights.ptr();
+	const int32_t heading_count = heading_weights.size();
 	int32_t last_index = 0;
 	for (int32_t effector_i = 0; effector_i < effector_list.size(); effector_i++) {
-		Ref<IKEffector3D> effector = effector_list[effector_i];
+		const Ref<IKEffector3D> &effector = effector_list[effector_i];
 		if (effector.is_null()) {
 			continue;
 		}
-		last_index = effector->update_effector_target_headings(r_target_headings, last_index, p_for_bone, &heading_weights);
+		int32_t end = MIN(last_index + effector->get_target_heading_count(), heading_count);
+		double scale = effector->get_heading_weight_scale(effector_tip_frames[effector_i].origin);
+		for (int32_t heading_i = last_index; heading_i < end; heading_i++) {
+			weights[heading_i] = base_weights[heading_i] * scale;
+			has_weight = has_weight || weights[heading_i] > 0.0;
+		}
+		last_index = end;
+	}
+	return has_weight;
+}
+
+void IKBoneSegment3D::_begin_tip_frames_motion(IKTransformStore3D *p_store, int32_t p_bone_handle) {
+	tip_frames_bone_handle = p_bone_handle;
+	tip_frames_bone_pose = p_store->get_global_transform(p_bone_handle);
+	tip_frames_bone_pose_inverse = tip_frames_bone_pose.affine_inverse();
+}
+
+void IKBoneSegment3D::_commit_tip_frames_motion(IKTransformStore3D *p_store) {
+	if (tip_frames_bone_handle == -1) {
+		return;
+	}
+	// Every effector of the segment is downstream of the solved bone, so all tips moved rigidly with it.
+	const Transform3D &pose = p_store->get_global_transform(tip_frames_bone_handle);
+	if (pose != tip_frames_bone_pose) {
+		Transform3D delta = pose * tip_frames_bone_pose_inverse;
+		for (Transform3D &frame : effector_tip_frames) {
+			frame = delta * frame;
+		}
 	}
+	tip_frames_bone_handle = -1;
 }
 
 void IKBoneSegment3D::_update_tip_headings(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_heading_tip) {
 	ERR_FAIL_NULL(r_heading_tip);
 	ERR_FAIL_COND(p_for_bone.is_null());
+	if (effector_tip_frames.size() != uint32_t(effector_list.size())) {
+		_refresh_tip_frames();
+	}
+	_write_tip_headings(p_for_bone, r_heading_tip->ptrw());
+}
+
+PackedVector3Array IKBoneSegment3D::get_carried_tip_headings(const Ref<IKBone3D> &p_for_bone) const {
+	PackedVector3Array headings;
+	ERR_FAIL_COND_V(p_for_bone.is_null(), headings);
+	if (effector_tip_frames.size() != uint32_t(effector_list.size())) {
+		return headings;
+	}
+	headings.resize(tip_headings.size());
+	_write_tip_headings(p_for_bone, headings.ptrw());
+	return headings;
+}
+
+void IKBoneSegment3D::_write_tip_headings(const Ref<IKBone3D> &p_for_bone, Vector3 *r_headings) const {
+	// Tips are carried along by the pending motion of the solved bone instead of being read back from the transform store.
+	bool moved = false;
+	Transform3D delta;
+	IKTransformStore3D *store = p_for_bone->get_transform_store();
+	if (store && tip_frames_bone_handle != -1) {
+		const Transform3D &pose = store->get_global_transform(tip_frames_bone_handle);
+		if (pose != tip_frames_bone_pose) {
+			delta = pose * tip_frames_bone_pose_inverse;
+			moved = true;
+		}
+	}
+	Vector3 bone_origin = p_for_bone->get_bone_direction_global_pose().origin;
 	int32_t last_index = 0;
 	for (int32_t effector_i = 0; effector_i < effector_list.size(); effector_i++) {
-		Ref<IKEffector3D> effector = effector_list[effector_i];
+		const Ref<IKEffector3D> &effector = effector_list[effector_i];
 		if (effector.is_null()) {
 			continue;
 		}
-		last_index = effector->update_effector_tip_headings(r_heading_tip, last_index, p_for_bone);
+		const Transform3D &frame = effector_tip_frames[effector_i];
+		last_index = effector->update_effector_tip_headings(r_headings, last_index, moved ? delta * frame : frame, bone_origin);
 	}
 }
 
-void IKBoneSegment3D::segment_solver(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration) {
-	for (Ref<IKBoneSegment3D> child : child_segments) {
-		if (child.is_null()) {
-			continue;
+void IKBoneSegment3D::segment_solver(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration, bool p_parallel_children) {
+	if (p_parallel_children && child_segments.size() > 1) {
+		_solve_child_segments_in_parallel(p_damp, p_default_damp, p_constraint_mode, p_current_iteration, p_total_iteration);
+	} else {
+		for (Ref<IKBoneSegment3D> child : child_segments) {
+			if (child.is_null()) {
+				continue;
+			}
+			child->segment_solver(p_damp, p_default_damp, p_constraint_mode, p_current_iteration, p_total_iteration, p_parallel_children);
 		}
-		child->segment_solver(p_damp, p_default_damp, p_constraint_mode, p_current_iteration, p_total_iteration);
 	}
 	bool is_translate = parent_segment.is_null();
 	if (is_translate) {
@@ -224,7 +458,49 @@ void IKBoneSegment3D::segment_solver(const Vector<float> &p_damp, float p_defaul
 	_qcp_solver(p_damp, p_default_damp, is_translate, p_constraint_mode, p_current_iteration, p_total_iteration);
 }
 
+void IKBoneSegment3D::_solve_child_segments_in_parallel(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration) {
+	IKTransformStore3D *store = root->get_transform_store();
+	ERR_FAIL_NULL(store);
+	// Sibling segments only write inside their own subtrees of the store. Refreshing this
+	// segment's subtree first means no two siblings ever refresh a shared ancestor at once.
+	store->update_subtree_global_transforms(root->get_ik_transform_handle());
+
+	ChildSolveParameters parameters;
+	parameters.damp = &p_damp;
+	parameters.default_damp = p_default_damp;
+	parameters.constraint_mode = p_constraint_mode;
+	parameters.current_iteration = p_current_iteration;
+	parameters.total_iterations = p_total_iteration;
+
+	child_tasks.clear();
+	for (int32_t child_i = 1; child_i < child_segments.size(); child_i++) {
+		const Ref<IKBoneSegment3D> &child = child_segments[child_i];
+		if (child.is_null()) {
+			continue;
+		}
+		child_tasks.push_back(WorkerThreadPool::get_singleton()->add_template_task(child.ptr(), &IKBoneSegment3D::_solve_child_segment_task, (const ChildSolveParameters *)&parameters, true, SNAME("IKBoneSegment3DSolveChild")));
+	}
+	// The first sibling runs on this thread while idle workers pick up the others.
+	const Ref<IKBoneSegment3D> &first_child = child_segments[0];
+	if (first_child.is_valid()) {
+		first_child->segment_solver(p_damp, p_default_damp, p_constraint_mode, p_current_iteration, p_total_iteration, true);
+	}
+	for (WorkerThreadPool::TaskID task_id : child_tasks) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	}
+}
+
+void IKBoneSegment3D::_solve_child_segment_task(const ChildSolveParameters *p_parameters) {
+	segment_solver(*p_parameters->damp, p_parameters->default_damp, p_parameters->constraint_mode, p_parameters->current_iteration, p_parameters->total_iterations, true);
+}
+
 void IKBoneSegment3D::_qcp_solver(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	// Child segments are final for this iteration, so the tips are read once here and then follow each solved bone.
+	_refresh_tip_frames();
+	if (!_update_heading_weights()) {
+		// Every pin of the segment is faded out, so QCP has nothing to fit and the bones keep their pose.
+		return;
+	}
 	for (Ref<IKBone3D> current_bone : bones) {
 		float damp = p_default_damp;
 		bool is_valid_access = !(unlikely((p_damp.size()) < 0 || (current_bone->get_bone_id()) >= (p_damp.size())));
@@ -242,6 +518,8 @@ void IKBoneSegment3D::_qcp_solver(const Vector<float> &p_damp, float p_default_d
 void IKBoneSegment3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_pinned"), &IKBoneSegment3D::is_pinned);
 	ClassDB::bind_method(D_METHOD("get_ik_bone", "bone"), &IKBoneSegment3D::get_ik_bone);
+	ClassDB::bind_method(D_METHOD("get_last_iteration_count"), &IKBoneSegment3D::get_last_iteration_count);
+	ClassDB::bind_method(D_METHOD("get_last_error"), &IKBoneSegment3D::get_last_error);
 }
 
 IKBoneSegment3D::IKBoneSegment3D(Skeleton3D *p_skeleton, StringName p_root_bone_name, Vector<Ref<IKEffectorTemplate3D>> &p_pins, ManyBoneIK3D *p_many_bone_ik, const Ref<IKBoneSegment3D> &p_parent,
@@ -261,6 +539,22 @@ IKBoneSegment3D::IKBoneSegment3D(Skeleton3D *p_skeleton, StringName p_root_bone_
 		root->set_parent(p_parent->get_tip());
 	}
 	default_stabilizing_pass_count = p_stabilizing_pass_count;
+	qcp_solver.set_precision(evec_prec);
+}
+
+void IKBoneSegment3D::set_stabilizing_pass_count(int32_t p_stabilizing_pass_count) {
+	default_stabilizing_pass_count = p_stabilizing_pass_count;
+}
+
+void IKBoneSegment3D::update_dampening(float p_default_damp, float p_iterations) {
+	// Segment roots are always created with a free dampening of PI; every other bone follows the default.
+	for (Ref<IKBone3D> current_bone = tip; current_bone.is_valid() && current_bone != root; current_bone = current_bone->get_parent()) {
+		current_bone->update_dampening(p_default_damp, p_iterations);
+	}
+	root->update_dampening(Math_PI, p_iterations);
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		child->update_dampening(p_default_damp, p_iterations);
+	}
 }
 
 void IKBoneSegment3D::_enable_pinned_descendants() {
@@ -278,6 +572,22 @@ Ref<IKBone3D> IKBoneSegment3D::get_ik_bone(BoneId p_bone) const {
 	return bone_map[p_bone];
 }
 
+void IKBoneSegment3D::create_transform_store(const Ref<IKNode3D> &p_origin) {
+	ERR_FAIL_COND_MSG(parent_segment.is_valid(), "Only a root segment owns a transform store.");
+	ERR_FAIL_COND(root.is_null());
+	transform_store.instantiate();
+	int32_t origin_handle = transform_store->add_node(-1);
+	if (p_origin.is_valid()) {
+		p_origin->bind_to_store(transform_store, origin_handle);
+	}
+	root->bind_transform_store(transform_store, origin_handle);
+	transform_store->update_global_transforms();
+}
+
+Ref<IKTransformStore3D> IKBoneSegment3D::get_transform_store() const {
+	return transform_store;
+}
+
 void IKBoneSegment3D::create_headings_arrays() {
 	Vector<Vector<double>> penalty_array;
 	Vector<Ref<IKBone3D>> new_pinned_bones;
@@ -291,13 +601,17 @@ void IKBoneSegment3D::create_headings_arrays() {
 		pinned_bones.write[bone_i] = new_pinned_bones[bone_i];
 	}
 	target_headings.resize(total_headings);
+	target_heading_points.resize(total_headings);
+	effector_target_versions.clear();
 	tip_headings.resize(total_headings);
 	tip_headings_uniform.resize(total_headings);
 	heading_weights.resize(total_headings);
+	heading_base_weights.resize(total_headings);
 	int currentHeading = 0;
 	for (const Vector<double> &current_penalty_array : penalty_array) {
 		for (double ad : current_penalty_array) {
 			heading_weights.write[currentHeading] = ad;
+			heading_base_weights.write[currentHeading] = ad;
 			target_headings.write[currentHeading] = Vector3();
 			tip_headings.write[currentHeading] = Vector3();
 			tip_headings_uniform.write[currentHeading] = Vector3();
@@ -32,13 +32,16 @@
 #define IK_BONE_SEGMENT_3D_H
 
 #include "ik_bone_3d.h"
+#include "ik_constraint_batch_3d.h"
 #include "ik_effector_3d.h"
 #include "ik_effector_template_3d.h"
+#include "math/ik_transform_store_3d.h"
 #include "math/qcp.h"
 #include "scene/3d/skeleton_3d.h"
 
 #include "core/io/resource.h"
 #include "core/object/ref_counted.h"
+#include "core/object/worker_thread_pool.h"
 
 class IKEffector3D;
 class IKBone3D;
@@ -46,6 +49,27 @@ class IKLimitCone3D;
 
 class IKBoneSegment3D : public Resource {
 	GDCLASS(IKBoneSegment3D, Resource);
+
+public:
+#ifdef DEBUG_ENABLED
+	struct SolverStats {
+		uint64_t solve_usec = 0;
+		uint64_t qcp_usec = 0;
+		uint64_t snap_usec = 0;
+		uint32_t stabilization_rollbacks = 0;
+		uint32_t constraint_snaps = 0;
+	};
+#endif
+
+private:
+	struct ChildSolveParameters {
+		const Vector<float> *damp = nullptr;
+		float default_damp = 0.0f;
+		bool constraint_mode = false;
+		int32_t current_iteration = 0;
+		int32_t total_iterations = 0;
+	};
+
 	Ref<IKBone3D> root;
 	Ref<IKBone3D> tip;
 	Vector<Ref<IKBone3D>> bones;
@@ -55,21 +79,45 @@ class IKBoneSegment3D : public Resource {
 	Ref<IKBoneSegment3D> root_segment;
 	Vector<Ref<IKEffector3D>> effector_list;
 	PackedVector3Array target_headings;
+	PackedVector3Array target_heading_points; // The bone independent part of target_headings, see IKEffector3D::update_effector_target_points().
+	LocalVector<uint32_t> effector_target_versions; // The effector target version each effector's points were computed for.
 	PackedVector3Array tip_headings;
 	PackedVector3Array tip_headings_uniform;
-	Vector<double> heading_weights;
+	// Each effector's tip frame, read once per iteration and then moved along with the bone being solved.
+	LocalVector<Transform3D> effector_tip_frames;
+	int32_t tip_frames_bone_handle = -1; // The bone whose motion since tip_frames_bone_pose is not yet applied to the tip frames.
+	Transform3D tip_frames_bone_pose;
+	Transform3D tip_frames_bone_pose_inverse;
+	Vector<double> heading_weights; // heading_base_weights scaled by each effector's blend weight and falloff; what QCP sees.
+	Vector<double> heading_base_weights; // The weights built from the pins, which also shape the target headings.
+	Ref<IKTransformStore3D> transform_store; // Owned by the root segment, shared by the whole segment tree.
+	QCPSolver qcp_solver; // Reused for every bone of the segment to keep the solve allocation free.
 	Skeleton3D *skeleton = nullptr;
 	bool pinned_descendants = false;
 	double previous_deviation = INFINITY;
 	int32_t default_stabilizing_pass_count = 0; // Move to the stabilizing pass to the ik solver. Set it free.
+	LocalVector<WorkerThreadPool::TaskID> child_tasks;
+	int32_t last_iteration_count = 0;
+	double last_error = -1.0;
+#ifdef DEBUG_ENABLED
+	SolverStats solver_stats; // Only touched by the thread solving this segment; read once the frame's solve has joined.
+#endif
+	void _solve_child_segments_in_parallel(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration);
+	void _solve_child_segment_task(const ChildSolveParameters *p_parameters);
 	bool _has_pinned_descendants();
 	void _enable_pinned_descendants();
+	void _update_target_heading_points();
 	void _update_target_headings(Ref<IKBone3D> p_for_bone, Vector<double> *r_weights, PackedVector3Array *r_htarget);
+	void _refresh_tip_frames();
+	bool _update_heading_weights(); // Returns false when every scaled weight is zero.
+	void _begin_tip_frames_motion(IKTransformStore3D *p_store, int32_t p_bone_handle);
+	void _commit_tip_frames_motion(IKTransformStore3D *p_store);
 	void _update_tip_headings(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_heading_tip);
+	void _write_tip_headings(const Ref<IKBone3D> &p_for_bone, Vector3 *r_headings) const;
 	void _set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_htip, PackedVector3Array *r_heading_tip, Vector<double> *r_weights, float p_dampening = -1, bool p_translate = false, bool p_constraint_mode = false, double current_iteration = 0, double total_iterations = 0);
 	void _qcp_solver(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations);
 	void _update_optimal_rotation(Ref<IKBone3D> p_for_bone, double p_damp, bool p_translate, bool p_constraint_mode, int32_t current_iteration, int32_t total_iterations);
-	float _get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights);
+	double _get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights);
 	HashMap<BoneId, Ref<IKBone3D>> bone_map;
 	bool _is_parent_of_tip(Ref<IKBone3D> p_current_tip, BoneId p_tip_bone);
 	bool _has_multiple_children_or_pinned(Vector<BoneId> &r_children, Ref<IKBone3D> p_current_tip);
@@ -84,17 +132,38 @@ protected:
 public:
 	const double evec_prec = static_cast<double>(1E-6);
 	void update_pinned_list(Vector<Vector<double>> &r_weights);
+	void update_dampening(float p_default_damp, float p_iterations);
+	void set_stabilizing_pass_count(int32_t p_stabilizing_pass_count);
 	static Quaternion clamp_to_cos_half_angle(Quaternion p_quat, double p_cos_half_angle);
 	static void recursive_create_headings_arrays_for(Ref<IKBoneSegment3D> p_bone_segment);
 	void create_headings_arrays();
 	void recursive_create_penalty_array(Ref<IKBoneSegment3D> p_bone_segment, Vector<Vector<double>> &r_penalty_array, Vector<Ref<IKBone3D>> &r_pinned_bones, double p_falloff);
-	void segment_solver(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration);
+	void segment_solver(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration, bool p_parallel_children = false);
 	Ref<IKBone3D> get_root() const;
 	Ref<IKBone3D> get_tip() const;
 	bool is_pinned() const;
 	Vector<Ref<IKBoneSegment3D>> get_child_segments() const;
 	void create_bone_list(Vector<Ref<IKBone3D>> &p_list, bool p_recursive = false) const;
+	// Adds a lane to r_batch for every constrained bone of the segment, for evaluating a whole pose in one pass.
+	void fill_constraint_batch(IKConstraintBatch3D &r_batch, bool p_recursive = false) const;
 	Ref<IKBone3D> get_ik_bone(BoneId p_bone) const;
+	void create_transform_store(const Ref<IKNode3D> &p_origin);
+	double compute_heading_error();
+	// The tip headings of p_for_bone built from the tip frames the solver carries along with each solved bone, rather
+	// than from the effectors' poses in the transform store. Empty until the segment has solved once.
+	PackedVector3Array get_carried_tip_headings(const Ref<IKBone3D> &p_for_bone) const;
+	void set_last_solve_result(int32_t p_iteration_count, double p_error);
+	int32_t get_last_iteration_count() const;
+	double get_last_error() const;
+	// Selects how the heading sums of this segment and its children are stored and accumulated.
+	void set_solver_precision(QCPSolver::ScalarPrecision p_precision);
+	QCPSolver::ScalarPrecision get_solver_precision() const;
+#ifdef DEBUG_ENABLED
+	SolverStats &get_solver_stats() { return solver_stats; }
+	void reset_solver_stats();
+	void accumulate_solver_stats(SolverStats &r_stats) const;
+#endif
+	Ref<IKTransformStore3D> get_transform_store() const;
 	void generate_default_segments(Vector<Ref<IKEffectorTemplate3D>> &p_pins, BoneId p_root_bone, BoneId p_tip_bone, ManyBoneIK3D *p_many_bone_ik);
 	IKBoneSegment3D() {}
 	IKBoneSegment3D(Skeleton3D *p_skeleton, StringName p_root_bone_name, Vector<Ref<IKEffectorTemplate3D>> &p_pins, ManyBoneIK3D *p_many_bone_ik, const Ref<IKBoneSegment3D> &p_parent = nullptr,
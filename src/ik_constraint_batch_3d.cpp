@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*  ik_constraint_batch_3d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_constraint_batch_3d.h"
+
+#include "ik_kusudama_3d.h"
+#include "math/ik_simd.h"
+
+void IKConstraintBatch3D::clear() {
+	constraints.clear();
+	bone_ids.clear();
+	control_x.clear();
+	control_y.clear();
+	control_z.clear();
+	radius_cosine.clear();
+	twist_half_range.clear();
+	general_lanes.clear();
+	direction_x.clear();
+	direction_y.clear();
+	direction_z.clear();
+	twist.clear();
+	in_bounds.clear();
+	twist_in_bounds.clear();
+}
+
+void IKConstraintBatch3D::add_lane(BoneId p_bone_id, const IKKusudama3D *p_constraint) {
+	ERR_FAIL_NULL(p_constraint);
+	uint32_t lane = constraints.size();
+	constraints.push_back(p_constraint);
+	bone_ids.push_back(p_bone_id);
+
+	Vector3 control_point;
+	double cone_radius_cosine = 2.0;
+	if (p_constraint->is_orientationally_constrained() && p_constraint->get_compiled_cone_count() == 1) {
+		p_constraint->get_compiled_cone(0, control_point, cone_radius_cosine);
+	} else {
+		general_lanes.push_back(lane);
+	}
+	control_x.push_back(control_point.x);
+	control_y.push_back(control_point.y);
+	control_z.push_back(control_point.z);
+	radius_cosine.push_back(cone_radius_cosine);
+	twist_half_range.push_back(p_constraint->is_axially_constrained() ? p_constraint->get_range_angle() / 2.0 : INFINITY);
+
+	direction_x.push_back(0.0);
+	direction_y.push_back(1.0);
+	direction_z.push_back(0.0);
+	twist.push_back(0.0);
+	in_bounds.push_back(1.0);
+	twist_in_bounds.push_back(1.0);
+}
+
+void IKConstraintBatch3D::evaluate(bool p_clamp) {
+	evaluate_lanes();
+
+	// A heading is within a single cone when cos(angle) > cos(radius), which the lanes test as a dot product against
+	// the unnormalized heading. Everything else goes through the kusudama itself.
+	for (uint32_t lane : general_lanes) {
+		const IKKusudama3D *constraint = constraints[lane];
+		if (!constraint->is_orientationally_constrained() || constraint->get_compiled_cone_count() == 0) {
+			in_bounds[lane] = 1.0;
+			continue;
+		}
+		double lane_in_bounds = 1.0;
+		Vector3 in_limits = constraint->get_local_point_in_limits(Vector3(direction_x[lane], direction_y[lane], direction_z[lane]), lane_in_bounds);
+		in_bounds[lane] = lane_in_bounds < 0.0 ? -1.0 : 1.0;
+		if (p_clamp && lane_in_bounds < 0.0) {
+			direction_x[lane] = in_limits.x;
+			direction_y[lane] = in_limits.y;
+			direction_z[lane] = in_limits.z;
+		}
+	}
+	if (!p_clamp) {
+		return;
+	}
+	const uint32_t lane_count = size();
+	for (uint32_t lane = 0; lane < lane_count; lane++) {
+		twist[lane] = CLAMP(twist[lane], -twist_half_range[lane], twist_half_range[lane]);
+		if (in_bounds[lane] > 0.0 || radius_cosine[lane] > 1.0) {
+			continue;
+		}
+		double lane_in_bounds = 1.0;
+		Vector3 in_limits = constraints[lane]->get_local_point_in_limits(Vector3(direction_x[lane], direction_y[lane], direction_z[lane]), lane_in_bounds);
+		direction_x[lane] = in_limits.x;
+		direction_y[lane] = in_limits.y;
+		direction_z[lane] = in_limits.z;
+	}
+}
+
+void IKConstraintBatch3D::evaluate_lanes_scalar(uint32_t p_begin) {
+	const uint32_t lane_count = size();
+	for (uint32_t lane = p_begin; lane < lane_count; lane++) {
+		double dot = direction_x[lane] * control_x[lane] + direction_y[lane] * control_y[lane] + direction_z[lane] * control_z[lane];
+		double length = Math::sqrt(direction_x[lane] * direction_x[lane] + direction_y[lane] * direction_y[lane] + direction_z[lane] * direction_z[lane]);
+		in_bounds[lane] = dot > radius_cosine[lane] * length ? 1.0 : -1.0;
+		twist_in_bounds[lane] = Math::abs(twist[lane]) <= twist_half_range[lane] ? 1.0 : -1.0;
+	}
+}
+
+#if defined(IK_SIMD_SSE2) || defined(IK_SIMD_NEON)
+
+void IKConstraintBatch3D::evaluate_lanes() {
+	const uint32_t lane_count = size();
+	const ik_f64x2 inside = ik_splat(1.0);
+	const ik_f64x2 outside = ik_splat(-1.0);
+	uint32_t lane = 0;
+	for (; lane + 2 <= lane_count; lane += 2) {
+		ik_f64x2 heading_x = ik_load(direction_x.ptr() + lane);
+		ik_f64x2 heading_y = ik_load(direction_y.ptr() + lane);
+		ik_f64x2 heading_z = ik_load(direction_z.ptr() + lane);
+		ik_f64x2 dot = ik_mul(heading_x, ik_load(control_x.ptr() + lane));
+		dot = ik_madd(dot, heading_y, ik_load(control_y.ptr() + lane));
+		dot = ik_madd(dot, heading_z, ik_load(control_z.ptr() + lane));
+		ik_f64x2 length_squared = ik_mul(heading_x, heading_x);
+		length_squared = ik_madd(length_squared, heading_y, heading_y);
+		length_squared = ik_madd(length_squared, heading_z, heading_z);
+		ik_f64x2 bound = ik_mul(ik_load(radius_cosine.ptr() + lane), ik_sqrt(length_squared));
+		ik_store(in_bounds.ptr() + lane, ik_select(ik_greater(dot, bound), inside, outside));
+
+		ik_mask64x2 in_range = ik_less_equal(ik_abs(ik_load(twist.ptr() + lane)), ik_load(twist_half_range.ptr() + lane));
+		ik_store(twist_in_bounds.ptr() + lane, ik_select(in_range, inside, outside));
+	}
+	evaluate_lanes_scalar(lane);
+}
+
+bool IKConstraintBatch3D::has_simd() {
+	return true;
+}
+
+#else
+
+void IKConstraintBatch3D::evaluate_lanes() {
+	evaluate_lanes_scalar(0);
+}
+
+bool IKConstraintBatch3D::has_simd() {
+	return false;
+}
+
+#endif
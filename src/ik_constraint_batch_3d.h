@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*  ik_constraint_batch_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef IK_CONSTRAINT_BATCH_3D_H
+#define IK_CONSTRAINT_BATCH_3D_H
+
+#include "core/templates/local_vector.h"
+#include "scene/3d/skeleton_3d.h"
+
+class IKKusudama3D;
+
+// The limits of many constrained bones evaluated in one pass, laid out as a structure of arrays with one lane per bone.
+// The single cone and twist tests, which cover most joints, run over two lanes per instruction where SSE2 or NEON is
+// available. Constraints are referenced without holding them, so add the lanes again whenever the constraints change.
+struct IKConstraintBatch3D {
+	// Per lane constraint data, filled by add_lane().
+	LocalVector<const IKKusudama3D *> constraints;
+	LocalVector<BoneId> bone_ids;
+	LocalVector<double> control_x;
+	LocalVector<double> control_y;
+	LocalVector<double> control_z;
+	LocalVector<double> radius_cosine; // Above 1 for lanes that need the full kusudama test.
+	LocalVector<double> twist_half_range; // Infinite when the twist is free.
+	LocalVector<uint32_t> general_lanes; // Lanes with several cones, or without orientation limits.
+
+	// Per lane pose, filled by the caller before evaluate().
+	LocalVector<double> direction_x; // The bone heading in its constraint's limiting frame.
+	LocalVector<double> direction_y;
+	LocalVector<double> direction_z;
+	LocalVector<double> twist; // Radians about the heading, from the middle of the twist range.
+
+	// Per lane results of evaluate(): 1 within the limits and -1 outside, as get_local_point_in_limits() reports.
+	LocalVector<double> in_bounds;
+	LocalVector<double> twist_in_bounds;
+
+	void clear();
+	void add_lane(BoneId p_bone_id, const IKKusudama3D *p_constraint);
+	uint32_t size() const { return constraints.size(); }
+	// With p_clamp, headings and twists outside the limits are replaced by the nearest allowed ones.
+	void evaluate(bool p_clamp);
+
+	// The single cone and twist tests over lanes [p_begin, size()).
+	void evaluate_lanes_scalar(uint32_t p_begin);
+	// Uses SSE2 or NEON when the target supports it and falls back to evaluate_lanes_scalar() otherwise.
+	void evaluate_lanes();
+	static bool has_simd();
+};
+
+#endif // IK_CONSTRAINT_BATCH_3D_H
@@ -0,0 +1,48 @@
+/**************************************************************************/
+/*  ik_constraint_frames_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef IK_CONSTRAINT_FRAMES_3D_H
+#define IK_CONSTRAINT_FRAMES_3D_H
+
+#include "core/math/basis.h"
+#include "core/math/quaternion.h"
+#include "core/math/transform_3d.h"
+
+// The global frames a constrained bone's limits are expressed in. They only depend on the parent bone, so the solver
+// computes them once per bone update and every limit reads them from here instead of walking the transform store.
+struct IKConstraintFrames3D {
+	Transform3D limiting; // The orientation (swing) limiting axes.
+	Basis limiting_inverse;
+	Quaternion twist_center; // The twist limiting axes rotated to the center of the twist range.
+	Quaternion twist_center_inverse;
+	Basis parent_inverse; // The constrained bone's parent, to bring the result back to a local transform.
+};
+
+#endif // IK_CONSTRAINT_FRAMES_3D_H
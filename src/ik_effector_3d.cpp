@@ -44,6 +44,7 @@
 void IKEffector3D::set_target_node(Skeleton3D *p_skeleton, const NodePath &p_target_node_path) {
 	ERR_FAIL_NULL(p_skeleton);
 	target_node_path = p_target_node_path;
+	clear_target_node_cache();
 }
 
 NodePath IKEffector3D::get_target_node() const {
@@ -68,46 +69,185 @@ bool IKEffector3D::is_following_translation_only() const {
 
 void IKEffector3D::set_direction_priorities(Vector3 p_direction_priorities) {
 	direction_priorities = p_direction_priorities;
+	target_version++;
 }
 
 Vector3 IKEffector3D::get_direction_priorities() const {
 	return direction_priorities;
 }
 
-void IKEffector3D::update_target_global_transform(Skeleton3D *p_skeleton, ManyBoneIK3D *p_many_bone_ik) {
-	ERR_FAIL_NULL(p_skeleton);
+Node3D *IKEffector3D::_get_target_node(const Node *p_path_base) {
+	if (!target_node_resolved) {
+		// A missing target is looked up again every frame until it shows up, since nothing signals its arrival.
+		Node3D *target_node = p_path_base ? cast_to<Node3D>(p_path_base->get_node_or_null(target_node_path)) : nullptr;
+		if (target_node) {
+			target_node_cache = target_node->get_instance_id();
+			// Leaving the tree covers the target or any of its ancestors being removed or moved.
+			target_node->connect(SNAME("tree_exiting"), callable_mp(this, &IKEffector3D::clear_target_node_cache));
+		}
+		target_node_resolved = target_node || target_node_path.is_empty();
+	}
+	return cast_to<Node3D>(ObjectDB::get_instance(target_node_cache));
+}
+
+void IKEffector3D::clear_target_node_cache() {
+	Node *target_node = cast_to<Node>(ObjectDB::get_instance(target_node_cache));
+	if (target_node) {
+		target_node->disconnect(SNAME("tree_exiting"), callable_mp(this, &IKEffector3D::clear_target_node_cache));
+	}
+	target_node_cache = ObjectID();
+	target_node_resolved = false;
+	static_target_read = false;
+}
+
+void IKEffector3D::notify_node_renamed(const Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	const Node *target_node = cast_to<Node>(ObjectDB::get_instance(target_node_cache));
+	if (target_node && (target_node == p_node || p_node->is_ancestor_of(target_node))) {
+		clear_target_node_cache();
+	}
+}
+
+void IKEffector3D::update_target_global_transform(const Transform3D &p_skeleton_inverse, ManyBoneIK3D *p_many_bone_ik) {
+	ERR_FAIL_NULL(p_many_bone_ik);
 	ERR_FAIL_COND(for_bone.is_null());
-	Node3D *current_target_node = cast_to<Node3D>(p_many_bone_ik->get_node_or_null(target_node_path));
-	if (current_target_node && current_target_node->is_visible_in_tree()) {
-		target_relative_to_skeleton_origin = p_skeleton->get_global_transform().affine_inverse() * current_target_node->get_global_transform();
+	if (target_transform_fed) {
+		return;
+	}
+	if (!target_static || !static_target_read) {
+		Node3D *current_target_node = _get_target_node(p_many_bone_ik);
+		if (!current_target_node || !current_target_node->is_visible_in_tree()) {
+			return;
+		}
+		target_node_global = current_target_node->get_global_transform();
+		static_target_read = target_static;
+	}
+	Transform3D target = p_skeleton_inverse * target_node_global;
+	if (target != target_relative_to_skeleton_origin) {
+		target_relative_to_skeleton_origin = target;
+		target_version++;
+	}
+}
+
+void IKEffector3D::set_blend_weight(real_t p_blend_weight) {
+	blend_weight = MAX(p_blend_weight, 0.0);
+}
+
+real_t IKEffector3D::get_blend_weight() const {
+	return blend_weight;
+}
+
+void IKEffector3D::set_weight_falloff_curve(const Ref<Curve> &p_curve) {
+	if (weight_falloff_curve == p_curve) {
+		return;
+	}
+	Callable update_table = callable_mp(this, &IKEffector3D::_update_weight_falloff_table);
+	if (weight_falloff_curve.is_valid() && weight_falloff_curve->is_connected(SNAME("changed"), update_table)) {
+		weight_falloff_curve->disconnect(SNAME("changed"), update_table);
+	}
+	weight_falloff_curve = p_curve;
+	if (weight_falloff_curve.is_valid()) {
+		weight_falloff_curve->connect(SNAME("changed"), update_table);
+	}
+	_update_weight_falloff_table();
+}
+
+void IKEffector3D::_update_weight_falloff_table() {
+	weight_falloff_table.clear();
+	if (weight_falloff_curve.is_null()) {
+		return;
+	}
+	const int32_t sample_count = 64;
+	weight_falloff_table.resize(sample_count);
+	for (int32_t sample_i = 0; sample_i < sample_count; sample_i++) {
+		real_t offset = real_t(sample_i) / (sample_count - 1);
+		weight_falloff_table[sample_i] = MAX(weight_falloff_curve->sample(offset), 0.0);
+	}
+}
+
+Ref<Curve> IKEffector3D::get_weight_falloff_curve() const {
+	return weight_falloff_curve;
+}
+
+void IKEffector3D::set_weight_falloff_distance(real_t p_distance) {
+	weight_falloff_distance = MAX(p_distance, 0.0);
+}
+
+real_t IKEffector3D::get_weight_falloff_distance() const {
+	return weight_falloff_distance;
+}
+
+double IKEffector3D::get_heading_weight_scale(const Vector3 &p_tip_origin) const {
+	double scale = blend_weight;
+	if (!weight_falloff_table.is_empty() && weight_falloff_distance > 0.0) {
+		real_t offset = CLAMP(p_tip_origin.distance_to(target_relative_to_skeleton_origin.origin) / weight_falloff_distance, 0.0, 1.0);
+		real_t position = offset * (weight_falloff_table.size() - 1);
+		int32_t sample_i = MIN(int32_t(position), int32_t(weight_falloff_table.size()) - 2);
+		scale *= Math::lerp(weight_falloff_table[sample_i], weight_falloff_table[sample_i + 1], position - sample_i);
 	}
+	return scale;
+}
+
+void IKEffector3D::set_target_static(bool p_static) {
+	target_static = p_static;
+	static_target_read = false;
+}
+
+bool IKEffector3D::is_target_static() const {
+	return target_static;
+}
+
+uint32_t IKEffector3D::get_target_version() const {
+	return target_version;
+}
+
+int32_t IKEffector3D::get_target_heading_count() const {
+	int32_t count = 1;
+	for (int axis = Vector3::AXIS_X; axis <= Vector3::AXIS_Z; ++axis) {
+		if (direction_priorities[axis] > 0.0) {
+			count += 2;
+		}
+	}
+	return count;
+}
+
+void IKEffector3D::set_target_transform(const Transform3D &p_transform) {
+	target_relative_to_skeleton_origin = p_transform;
+	target_transform_fed = true;
+	target_version++;
+}
+
+void IKEffector3D::clear_target_transform() {
+	target_transform_fed = false;
+	static_target_read = false;
+}
+
+bool IKEffector3D::is_target_transform_fed() const {
+	return target_transform_fed;
 }
 
 Transform3D IKEffector3D::get_target_global_transform() const {
 	return target_relative_to_skeleton_origin;
 }
 
-int32_t IKEffector3D::update_effector_target_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone, const Vector<double> *p_weights) const {
+int32_t IKEffector3D::update_effector_target_points(Vector3 *r_points, int32_t p_index, const double *p_weights) const {
 	ERR_FAIL_COND_V(p_index == -1, -1);
-	ERR_FAIL_NULL_V(p_headings, -1);
-	ERR_FAIL_COND_V(p_for_bone.is_null(), -1);
+	ERR_FAIL_NULL_V(r_points, -1);
 	ERR_FAIL_NULL_V(p_weights, -1);
 
+	// Each heading is point - scale * bone_origin, with a scale of 1 for the origin heading and the heading weight otherwise.
 	int32_t index = p_index;
-	Vector3 bone_origin_relative_to_skeleton_origin = for_bone->get_bone_direction_global_pose().origin;
-	p_headings->write[index] = target_relative_to_skeleton_origin.origin - bone_origin_relative_to_skeleton_origin;
+	r_points[index] = target_relative_to_skeleton_origin.origin;
 	index++;
 	Vector3 priority = get_direction_priorities();
 	for (int axis = Vector3::AXIS_X; axis <= Vector3::AXIS_Z; ++axis) {
 		if (priority[axis] > 0.0) {
-			real_t w = p_weights->get(index);
+			real_t w = p_weights[index];
 			Vector3 column = target_relative_to_skeleton_origin.basis.get_column(axis);
 
-			p_headings->write[index] = (column + target_relative_to_skeleton_origin.origin) - bone_origin_relative_to_skeleton_origin;
-			p_headings->write[index] *= Vector3(w, w, w);
+			r_points[index] = (column + target_relative_to_skeleton_origin.origin) * w;
 			index++;
-			p_headings->write[index] = (target_relative_to_skeleton_origin.origin - column) - bone_origin_relative_to_skeleton_origin;
-			p_headings->write[index] *= Vector3(w, w, w);
+			r_points[index] = (target_relative_to_skeleton_origin.origin - column) * w;
 			index++;
 		}
 	}
@@ -115,32 +255,51 @@ int32_t IKEffector3D::update_effector_target_headings(PackedVector3Array *p_head
 	return index;
 }
 
+int32_t IKEffector3D::recenter_target_headings(const Vector3 *p_points, Vector3 *r_headings, int32_t p_index, const double *p_weights) const {
+	ERR_FAIL_COND_V(p_index == -1, -1);
+	ERR_FAIL_NULL_V(p_points, -1);
+	ERR_FAIL_NULL_V(r_headings, -1);
+	ERR_FAIL_NULL_V(p_weights, -1);
+
+	Vector3 bone_origin_relative_to_skeleton_origin = for_bone->get_bone_direction_global_pose().origin;
+	r_headings[p_index] = p_points[p_index] - bone_origin_relative_to_skeleton_origin;
+	int32_t end = p_index + get_target_heading_count();
+	for (int32_t index = p_index + 1; index < end; index++) {
+		real_t w = p_weights[index];
+		r_headings[index] = p_points[index] - bone_origin_relative_to_skeleton_origin * w;
+	}
+	return end;
+}
+
 int32_t IKEffector3D::update_effector_tip_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone) const {
 	ERR_FAIL_COND_V(p_index == -1, -1);
 	ERR_FAIL_NULL_V(p_headings, -1);
 	ERR_FAIL_COND_V(p_for_bone.is_null(), -1);
 
-	Transform3D tip_xform_relative_to_skeleton_origin = for_bone->get_bone_direction_global_pose();
-	Basis tip_basis = tip_xform_relative_to_skeleton_origin.basis;
-	Vector3 bone_origin_relative_to_skeleton_origin = p_for_bone->get_bone_direction_global_pose().origin;
+	return update_effector_tip_headings(p_headings->ptrw(), p_index, for_bone->get_bone_direction_global_pose(), p_for_bone->get_bone_direction_global_pose().origin);
+}
+
+int32_t IKEffector3D::update_effector_tip_headings(Vector3 *r_headings, int32_t p_index, const Transform3D &p_tip_frame, const Vector3 &p_bone_origin) const {
+	ERR_FAIL_COND_V(p_index == -1, -1);
+	ERR_FAIL_NULL_V(r_headings, -1);
 
 	int32_t index = p_index;
-	p_headings->write[index] = tip_xform_relative_to_skeleton_origin.origin - bone_origin_relative_to_skeleton_origin;
+	r_headings[index] = p_tip_frame.origin - p_bone_origin;
 	index++;
-	double distance = target_relative_to_skeleton_origin.origin.distance_to(bone_origin_relative_to_skeleton_origin);
+	double distance = target_relative_to_skeleton_origin.origin.distance_to(p_bone_origin);
 	double scale_by = MIN(distance, 1.0f);
 	const Vector3 priority = get_direction_priorities();
 
 	for (int axis = Vector3::AXIS_X; axis <= Vector3::AXIS_Z; ++axis) {
 		if (priority[axis] > 0.0) {
-			Vector3 column = tip_basis.get_column(axis) * priority[axis];
+			Vector3 column = p_tip_frame.basis.get_column(axis) * priority[axis];
 
-			p_headings->write[index] = (column + tip_xform_relative_to_skeleton_origin.origin) - bone_origin_relative_to_skeleton_origin;
-			p_headings->write[index] *= scale_by;
+			r_headings[index] = (column + p_tip_frame.origin) - p_bone_origin;
+			r_headings[index] *= scale_by;
 			index++;
 
-			p_headings->write[index] = (tip_xform_relative_to_skeleton_origin.origin - column) - bone_origin_relative_to_skeleton_origin;
-			p_headings->write[index] *= scale_by;
+			r_headings[index] = (p_tip_frame.origin - column) - p_bone_origin;
+			r_headings[index] *= scale_by;
 			index++;
 		}
 	}
@@ -163,6 +322,7 @@ void IKEffector3D::_bind_methods() {
 
 void IKEffector3D::set_weight(real_t p_weight) {
 	weight = p_weight;
+	target_version++;
 }
 
 real_t IKEffector3D::get_weight() const {
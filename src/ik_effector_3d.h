@@ -34,7 +34,9 @@
 #include "math/ik_node_3d.h"
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "scene/3d/skeleton_3d.h"
+#include "scene/resources/curve.h"
 
 #define MIN_SCALE 0.1
 
@@ -49,9 +51,13 @@ class IKEffector3D : public Resource {
 	Ref<IKBone3D> for_bone;
 	bool use_target_node_rotation = true;
 	NodePath target_node_path;
-	ObjectID target_node_cache;
-	Node *target_node_reference = nullptr;
+	ObjectID target_node_cache; // Resolved from target_node_path on first use and kept until the node or its path changes.
+	bool target_node_resolved = false;
+	bool target_transform_fed = false; // Written from code; the scene tree is never consulted for this target.
 	bool target_static = false;
+	bool static_target_read = false; // A static target's node is read once, then target_node_global is kept.
+	Transform3D target_node_global; // Moved into skeleton space every frame, since the skeleton may move under a static target.
+	uint32_t target_version = 1; // Bumped whenever the target transform, weight or priorities change.
 	Transform3D target_transform;
 
 	Transform3D target_relative_to_skeleton_origin;
@@ -59,11 +65,20 @@ class IKEffector3D : public Resource {
 	// See IKEffectorTemplate to change the defaults.
 	real_t weight = 0.0;
 	real_t motion_propagation_factor = 0.0;
+	// Applied to the segment's heading weights every iteration, so changing them needs no rebuild.
+	real_t blend_weight = 1.0;
+	Ref<Curve> weight_falloff_curve;
+	// weight_falloff_curve sampled on the main thread whenever it changes, so solver threads never bake the Curve.
+	LocalVector<real_t> weight_falloff_table;
+	real_t weight_falloff_distance = 1.0;
 	PackedVector3Array target_headings;
 	PackedVector3Array tip_headings;
 	Vector<real_t> heading_weights;
 	Vector3 direction_priorities;
 
+	Node3D *_get_target_node(const Node *p_path_base);
+	void _update_weight_falloff_table();
+
 protected:
 	static void _bind_methods();
 
@@ -73,7 +88,15 @@ public:
 	real_t get_weight() const;
 	void set_direction_priorities(Vector3 p_direction_priorities);
 	Vector3 get_direction_priorities() const;
-	void update_target_global_transform(Skeleton3D *p_skeleton, ManyBoneIK3D *p_modification = nullptr);
+	// p_skeleton_inverse is the inverse of the skeleton's global transform, shared by every effector of the frame.
+	void update_target_global_transform(const Transform3D &p_skeleton_inverse, ManyBoneIK3D *p_many_bone_ik);
+	void clear_target_node_cache();
+	// Drops the cached target when p_node is the target or one of its ancestors, as the path may no longer lead to it.
+	void notify_node_renamed(const Node *p_node);
+	// Sets the target relative to the skeleton and stops following the target node until clear_target_transform().
+	void set_target_transform(const Transform3D &p_transform);
+	void clear_target_transform();
+	bool is_target_transform_fed() const;
 	const float MAX_KUSUDAMA_OPEN_CONES = 30;
 	float get_motion_propagation_factor() const;
 	void set_motion_propagation_factor(float p_motion_propagation_factor);
@@ -84,8 +107,25 @@ public:
 	bool get_target_node_rotation() const;
 	Ref<IKBone3D> get_ik_bone_3d() const;
 	bool is_following_translation_only() const;
-	int32_t update_effector_target_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone, const Vector<double> *p_weights) const;
+	void set_blend_weight(real_t p_blend_weight);
+	real_t get_blend_weight() const;
+	void set_weight_falloff_curve(const Ref<Curve> &p_curve);
+	Ref<Curve> get_weight_falloff_curve() const;
+	void set_weight_falloff_distance(real_t p_distance);
+	real_t get_weight_falloff_distance() const;
+	// The factor the pin's heading weights are scaled by with the tip at p_tip_origin, relative to the skeleton.
+	double get_heading_weight_scale(const Vector3 &p_tip_origin) const;
+	void set_target_static(bool p_static);
+	bool is_target_static() const;
+	uint32_t get_target_version() const;
+	int32_t get_target_heading_count() const;
+	// Writes the parts of the target headings that only depend on the target, starting at p_index. Returns the next index.
+	int32_t update_effector_target_points(Vector3 *r_points, int32_t p_index, const double *p_weights) const;
+	// Turns the points written by update_effector_target_points() into headings relative to the effector's bone origin.
+	int32_t recenter_target_headings(const Vector3 *p_points, Vector3 *r_headings, int32_t p_index, const double *p_weights) const;
 	int32_t update_effector_tip_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone) const;
+	// Same as above from an already known tip frame and origin of the bone being solved, without reading any poses.
+	int32_t update_effector_tip_headings(Vector3 *r_headings, int32_t p_index, const Transform3D &p_tip_frame, const Vector3 &p_bone_origin) const;
 	IKEffector3D(const Ref<IKBone3D> &p_current_bone);
 };
 
@@ -39,19 +39,35 @@ void IKEffectorTemplate3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_target_node"), &IKEffectorTemplate3D::get_target_node);
 	ClassDB::bind_method(D_METHOD("set_target_node", "target_node"), &IKEffectorTemplate3D::set_target_node);
 
+	ClassDB::bind_method(D_METHOD("is_target_static"), &IKEffectorTemplate3D::is_target_static);
+	ClassDB::bind_method(D_METHOD("set_target_static", "target_static"), &IKEffectorTemplate3D::set_target_static);
+
 	ClassDB::bind_method(D_METHOD("get_motion_propagation_factor"), &IKEffectorTemplate3D::get_motion_propagation_factor);
 	ClassDB::bind_method(D_METHOD("set_motion_propagation_factor", "motion_propagation_factor"), &IKEffectorTemplate3D::set_motion_propagation_factor);
 
 	ClassDB::bind_method(D_METHOD("get_weight"), &IKEffectorTemplate3D::get_weight);
 	ClassDB::bind_method(D_METHOD("set_weight", "weight"), &IKEffectorTemplate3D::set_weight);
 
+	ClassDB::bind_method(D_METHOD("get_blend_weight"), &IKEffectorTemplate3D::get_blend_weight);
+	ClassDB::bind_method(D_METHOD("set_blend_weight", "blend_weight"), &IKEffectorTemplate3D::set_blend_weight);
+
+	ClassDB::bind_method(D_METHOD("get_weight_falloff_curve"), &IKEffectorTemplate3D::get_weight_falloff_curve);
+	ClassDB::bind_method(D_METHOD("set_weight_falloff_curve", "curve"), &IKEffectorTemplate3D::set_weight_falloff_curve);
+
+	ClassDB::bind_method(D_METHOD("get_weight_falloff_distance"), &IKEffectorTemplate3D::get_weight_falloff_distance);
+	ClassDB::bind_method(D_METHOD("set_weight_falloff_distance", "distance"), &IKEffectorTemplate3D::set_weight_falloff_distance);
+
 	ClassDB::bind_method(D_METHOD("get_direction_priorities"), &IKEffectorTemplate3D::get_direction_priorities);
 	ClassDB::bind_method(D_METHOD("set_direction_priorities", "direction_priorities"), &IKEffectorTemplate3D::set_direction_priorities);
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "motion_propagation_factor"), "set_motion_propagation_factor", "get_motion_propagation_factor");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "weight"), "set_weight", "get_weight");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "blend_weight", PROPERTY_HINT_RANGE, "0,1,0.01,or_greater"), "set_blend_weight", "get_blend_weight");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "weight_falloff_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_weight_falloff_curve", "get_weight_falloff_curve");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "weight_falloff_distance", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater,suffix:m"), "set_weight_falloff_distance", "get_weight_falloff_distance");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "direction_priorities"), "set_direction_priorities", "get_direction_priorities");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "target_node"), "set_target_node", "get_target_node");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "target_static"), "set_target_static", "is_target_static");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "root_bone"), "set_root_bone", "get_root_bone");
 }
 
@@ -32,7 +32,9 @@
 #define IK_EFFECTOR_TEMPLATE_3D_H
 
 #include "core/io/resource.h"
+#include "core/math/transform_3d.h"
 #include "core/string/node_path.h"
+#include "scene/resources/curve.h"
 
 class IKEffectorTemplate3D : public Resource {
 	GDCLASS(IKEffectorTemplate3D, Resource);
@@ -42,7 +44,14 @@ class IKEffectorTemplate3D : public Resource {
 	bool target_static = false;
 	real_t motion_propagation_factor = 0.0f;
 	real_t weight = 1.0f;
+	real_t blend_weight = 1.0f;
+	Ref<Curve> weight_falloff_curve;
+	real_t weight_falloff_distance = 1.0f;
 	Vector3 priority_direction = Vector3(0.2f, 0.0f, 0.2f); // Purported ideal values are 1.0 / 3.0 for one direction, 1.0 / 5.0 for two directions and 1.0 / 7.0 for three directions.
+	// Fed from code through ManyBoneIK3D::set_pin_target_transform() and not saved. Replaces target_node while set.
+	Transform3D target_transform;
+	bool target_transform_fed = false;
+
 protected:
 	static void _bind_methods();
 
@@ -51,12 +60,27 @@ public:
 	void set_root_bone(String p_root_bone);
 	NodePath get_target_node() const;
 	void set_target_node(NodePath p_node_path);
+	bool is_target_static() const { return target_static; }
+	void set_target_static(bool p_static) { target_static = p_static; }
 	float get_motion_propagation_factor() const;
 	void set_motion_propagation_factor(float p_motion_propagation_factor);
 	real_t get_weight() const { return weight; }
 	void set_weight(real_t p_weight) { weight = p_weight; }
+	real_t get_blend_weight() const { return blend_weight; }
+	void set_blend_weight(real_t p_blend_weight) { blend_weight = MAX(p_blend_weight, 0.0f); }
+	Ref<Curve> get_weight_falloff_curve() const { return weight_falloff_curve; }
+	void set_weight_falloff_curve(const Ref<Curve> &p_curve) { weight_falloff_curve = p_curve; }
+	real_t get_weight_falloff_distance() const { return weight_falloff_distance; }
+	void set_weight_falloff_distance(real_t p_distance) { weight_falloff_distance = MAX(p_distance, 0.0f); }
 	Vector3 get_direction_priorities() const { return priority_direction; }
 	void set_direction_priorities(Vector3 p_priority_direction) { priority_direction = p_priority_direction; }
+	Transform3D get_target_transform() const { return target_transform; }
+	void set_target_transform(const Transform3D &p_transform) {
+		target_transform = p_transform;
+		target_transform_fed = true;
+	}
+	void clear_target_transform() { target_transform_fed = false; }
+	bool is_target_transform_fed() const { return target_transform_fed; }
 
 	IKEffectorTemplate3D();
 };
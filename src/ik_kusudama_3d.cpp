@@ -76,15 +76,7 @@ void IKKusudama3D::_update_constraint(Ref<IKNode3D> p_limiting_axes) {
 	Quaternion old_y_to_new_y = Quaternion(p_limiting_axes->get_global_transform().get_basis().get_column(Vector3::AXIS_Y).normalized(), p_limiting_axes->get_global_transform().get_basis().xform(new_y_ray.origin).normalized());
 	p_limiting_axes->rotate_local_with_global(old_y_to_new_y);
 
-	for (Ref<IKLimitCone3D> open_cone : open_cones) {
-		if (open_cone.is_null()) {
-			continue;
-		}
-
-		Vector3 control_point = open_cone->get_control_point();
-		open_cone->set_control_point(control_point.normalized());
-	}
-
+	// The cones keep their control points normalized, so only the tangents and the compiled copy need refreshing.
 	update_tangent_radii();
 }
 
@@ -98,6 +90,121 @@ void IKKusudama3D::update_tangent_radii() {
 		Ref<IKLimitCone3D> cone = open_cones[i];
 		cone->update_tangent_handles(next);
 	}
+	_compile_open_cones();
+}
+
+void IKKusudama3D::notify_open_cones_changed() {
+	update_tangent_radii();
+}
+
+void IKKusudama3D::_compile_open_cones() {
+	compiled_cones.clear();
+	compiled_cone_pairs.clear();
+
+	Ref<IKLimitCone3D> previous;
+	for (const Ref<IKLimitCone3D> &cone : open_cones) {
+		if (cone.is_null()) {
+			continue;
+		}
+		CompiledCone compiled;
+		compiled.control_point = cone->get_control_point().normalized();
+		compiled.radius = cone->get_radius();
+		compiled.radius_cosine = cone->get_radius_cosine();
+		compiled.radius_sine = Math::sin(compiled.radius);
+		compiled.radius_half_cosine = Math::cos(compiled.radius / 2.0);
+		compiled_cones.push_back(compiled);
+
+		if (previous.is_valid()) {
+			const Vector3 &c1 = compiled_cones[compiled_cones.size() - 2].control_point;
+			const Vector3 &c2 = compiled.control_point;
+			Vector3 t1 = previous->get_tangent_circle_center_next_1().normalized();
+			Vector3 t2 = previous->get_tangent_circle_center_next_2().normalized();
+
+			CompiledConePair pair;
+			pair.control_cross = c1.cross(c2);
+			pair.tangent_centers[0] = t1;
+			pair.tangent_centers[1] = t2;
+			pair.boundary_normals[0][0] = c1.cross(t1).normalized();
+			pair.boundary_normals[0][1] = t1.cross(c2).normalized();
+			pair.boundary_normals[1][0] = t2.cross(c1).normalized();
+			pair.boundary_normals[1][1] = c2.cross(t2).normalized();
+			pair.tangent_radius = previous->get_tangent_circle_radius_next();
+			pair.tangent_radius_cosine = Math::cos(pair.tangent_radius);
+			pair.tangent_radius_sine = Math::sin(pair.tangent_radius);
+			compiled_cone_pairs.push_back(pair);
+		}
+		previous = cone;
+	}
+	single_cone = compiled_cones.size() == 1;
+	_build_bounds_grid();
+}
+
+void IKKusudama3D::_build_bounds_grid() {
+	bounds_grid.clear();
+	if (bounds_grid_resolution <= 0 || compiled_cones.is_empty()) {
+		return;
+	}
+	const int32_t cell_count = bounds_grid_resolution * bounds_grid_resolution;
+	bounds_grid.resize((cell_count + 31) / 32);
+	for (uint32_t &word : bounds_grid) {
+		word = 0;
+	}
+	const real_t cell_size = real_t(1.0) / bounds_grid_resolution;
+	for (int32_t y = 0; y < bounds_grid_resolution; y++) {
+		for (int32_t x = 0; x < bounds_grid_resolution; x++) {
+			// With an even resolution every cell maps to at most two geodesic triangles spanned by its corners, so the
+			// cap around the cell center that reaches the farthest corner contains the whole cell.
+			Vector2 corner = Vector2(x, y) * cell_size;
+			Vector3 center = Vector3::octahedron_decode(corner + Vector2(cell_size, cell_size) * 0.5);
+			real_t cell_radius = 0;
+			for (int32_t corner_i = 0; corner_i < 4; corner_i++) {
+				Vector3 corner_direction = Vector3::octahedron_decode(corner + Vector2(corner_i & 1, corner_i >> 1) * cell_size);
+				cell_radius = MAX(cell_radius, center.angle_to(corner_direction));
+			}
+			for (const CompiledCone &cone : compiled_cones) {
+				if (center.angle_to(cone.control_point) + cell_radius + CMP_EPSILON < cone.radius) {
+					int32_t cell = y * bounds_grid_resolution + x;
+					bounds_grid[cell >> 5] |= 1u << (cell & 31);
+					break;
+				}
+			}
+		}
+	}
+}
+
+int32_t IKKusudama3D::_get_bounds_grid_cell(const Vector3 &p_direction) const {
+	Vector2 uv = p_direction.octahedron_encode() * bounds_grid_resolution;
+	int32_t x = CLAMP(int32_t(uv.x), 0, bounds_grid_resolution - 1);
+	int32_t y = CLAMP(int32_t(uv.y), 0, bounds_grid_resolution - 1);
+	return y * bounds_grid_resolution + x;
+}
+
+void IKKusudama3D::set_bounds_grid_resolution(int32_t p_resolution) {
+	int32_t resolution = p_resolution <= 0 ? 0 : CLAMP(p_resolution, 4, 1024);
+	resolution += resolution & 1;
+	if (resolution == bounds_grid_resolution) {
+		return;
+	}
+	bounds_grid_resolution = resolution;
+	_build_bounds_grid();
+}
+
+int32_t IKKusudama3D::get_bounds_grid_resolution() const {
+	return bounds_grid_resolution;
+}
+
+int64_t IKKusudama3D::get_bounds_grid_memory_usage() const {
+	return int64_t(bounds_grid.size()) * sizeof(uint32_t);
+}
+
+Vector3 IKKusudama3D::_rotate_toward(const Vector3 &p_from, const Vector3 &p_toward, double p_angle, double p_cos, double p_sin) {
+	// Rotating p_from by p_angle about p_from x p_toward, written out so no quaternion has to be built.
+	Vector3 perpendicular = p_toward - p_from * p_from.dot(p_toward);
+	real_t perpendicular_length_squared = perpendicular.length_squared();
+	if (Math::is_zero_approx(perpendicular_length_squared)) {
+		return get_quaternion_axis_angle(Vector3(0, 1, 0), p_angle).xform(p_from);
+	}
+	return p_from * p_cos + perpendicular * (p_sin / Math::sqrt(perpendicular_length_squared));
 }
 
 void IKKusudama3D::set_axial_limits(real_t min_angle, real_t in_range) {
@@ -114,21 +221,215 @@ void IKKusudama3D::set_axial_limits(real_t min_angle, real_t in_range) {
 	twist_max_rot = Quaternion(z_axis, twist_max_vec);
 }
 
-void IKKusudama3D::set_snap_to_twist_limit(Ref<IKNode3D> p_bone_direction, Ref<IKNode3D> p_to_set, Ref<IKNode3D> p_constraint_axes, real_t p_dampening, real_t p_cos_half_dampen) {
-	if (!is_axially_constrained()) {
-		return;
+bool IKKusudama3D::is_single_cone() const {
+	return single_cone;
+}
+
+int32_t IKKusudama3D::get_compiled_cone_count() const {
+	return compiled_cones.size();
+}
+
+void IKKusudama3D::get_compiled_cone(int32_t p_index, Vector3 &r_control_point, double &r_radius_cosine) const {
+	ERR_FAIL_INDEX(p_index, int32_t(compiled_cones.size()));
+	r_control_point = compiled_cones[p_index].control_point;
+	r_radius_cosine = compiled_cones[p_index].radius_cosine;
+}
+
+static Transform3D _get_frame_global_transform(const IKTransformStore3D *p_store, int32_t p_handle) {
+	int32_t parent = p_store->get_parent(p_handle);
+	Transform3D global_transform = parent == -1 ? p_store->get_transform(p_handle) : p_store->get_global_transform(parent) * p_store->get_transform(p_handle);
+	if (p_store->is_scale_disabled(p_handle)) {
+		global_transform.basis.orthogonalize();
+	}
+	return global_transform;
+}
+
+void IKKusudama3D::compute_constraint_frames(const IKTransformStore3D *p_store, int32_t p_to_set, int32_t p_limiting_axes, int32_t p_twist_axes, IKConstraintFrames3D &r_frames) const {
+	ERR_FAIL_NULL(p_store);
+	ERR_FAIL_COND(p_to_set == -1 || p_limiting_axes == -1 || p_twist_axes == -1);
+	int32_t parent = p_store->get_parent(p_to_set);
+	ERR_FAIL_COND(parent == -1);
+	compute_constraint_frames(_get_frame_global_transform(p_store, p_limiting_axes), _get_frame_global_transform(p_store, p_twist_axes), r_frames);
+	r_frames.parent_inverse = p_store->get_global_inverse(parent).basis;
+}
+
+void IKKusudama3D::compute_constraint_frames(const Transform3D &p_limiting_axes, const Transform3D &p_twist_axes, IKConstraintFrames3D &r_frames) const {
+	r_frames.limiting = p_limiting_axes;
+	r_frames.limiting_inverse = r_frames.limiting.basis.inverse();
+	r_frames.twist_center = p_twist_axes.basis.get_rotation_quaternion() * twist_center_rot;
+	r_frames.twist_center_inverse = r_frames.twist_center.inverse();
+	r_frames.parent_inverse = Basis();
+}
+
+void IKKusudama3D::get_limit_violation(const IKConstraintFrames3D &p_frames, const Basis &p_bone_basis, const Vector3 &p_tip, real_t &r_swing, real_t &r_twist) const {
+	r_swing = 0;
+	r_twist = 0;
+	if (is_orientationally_constrained() && get_compiled_cone_count() > 0) {
+		Vector3 local_heading = p_frames.limiting_inverse.xform(p_tip - p_frames.limiting.origin);
+		if (!local_heading.is_zero_approx()) {
+			double in_bounds = 1.0;
+			Vector3 in_limits = get_local_point_in_limits(local_heading, in_bounds);
+			if (in_bounds < 0) {
+				r_swing = local_heading.angle_to(in_limits);
+			}
+		}
+	}
+	if (is_axially_constrained()) {
+		Quaternion align_rot = (p_frames.twist_center_inverse * p_bone_basis.get_rotation_quaternion()).normalized();
+		Quaternion swing_rotation, twist_rotation;
+		get_swing_twist(align_rot, Vector3(0, 1, 0), swing_rotation, twist_rotation);
+		if (Math::abs(twist_rotation.w) < twist_half_range_half_cos) {
+			real_t twist_angle = 2.0 * Math::acos(MIN(real_t(1.0), real_t(Math::abs(twist_rotation.w))));
+			r_twist = MAX(real_t(0.0), twist_angle - range_angle / real_t(2.0));
+		}
+	}
+}
+
+uint32_t IKKusudama3D::apply_limits(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, int32_t p_limiting_axes, int32_t p_twist_axes) {
+	ERR_FAIL_NULL_V(p_store, 0);
+	if (p_bone_direction == -1 || p_to_set == -1 || p_limiting_axes == -1 || p_twist_axes == -1) {
+		return 0;
+	}
+	ERR_FAIL_COND_V(p_store->get_parent(p_to_set) == -1, 0);
+	IKConstraintFrames3D frames;
+	compute_constraint_frames(p_store, p_to_set, p_limiting_axes, p_twist_axes, frames);
+	return apply_limits(p_store, p_bone_direction, p_to_set, frames);
+}
+
+uint32_t IKKusudama3D::apply_limits(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, const IKConstraintFrames3D &p_frames) {
+	ERR_FAIL_NULL_V(p_store, 0);
+	if (p_bone_direction == -1 || p_to_set == -1) {
+		return 0;
+	}
+
+	// Everything happens in the twist center frame, so the twist decomposition below needs no extra change of basis.
+	const Quaternion &twist_center_inverse = p_frames.twist_center_inverse;
+	Quaternion align_rot = (twist_center_inverse * p_store->get_global_transform(p_to_set).basis.get_rotation_quaternion()).normalized();
+	uint32_t snap_count = 0;
+
+	if (is_orientationally_constrained()) {
+		const Transform3D &limiting_global = p_frames.limiting;
+		Vector3 heading = p_store->get_global_transform(p_bone_direction).xform(Vector3(0, 1, 0)) - limiting_global.origin;
+		Vector3 direction = twist_center_inverse.xform(heading).normalized();
+		if (is_single_cone()) {
+			const CompiledCone &cone = compiled_cones[0];
+			Vector3 control_point = twist_center_inverse.xform(limiting_global.basis.xform(cone.control_point)).normalized();
+			// The swing from the control point is within the cone when cos(angle) > cos(radius), which is one dot product.
+			if (!direction.is_zero_approx() && control_point.dot(direction) <= cone.radius_cosine) {
+				Quaternion swing = Quaternion(control_point, direction);
+				Quaternion clamped_swing = IKBoneSegment3D::clamp_to_cos_half_angle(swing, cone.radius_half_cosine);
+				align_rot = (clamped_swing * swing.inverse() * align_rot).normalized();
+				snap_count++;
+			}
+		} else {
+			double in_bounds = 1.0;
+			Vector3 bone_tip = p_frames.limiting_inverse.xform(heading);
+			Vector3 in_limits = get_local_point_in_limits(bone_tip, in_bounds);
+			if (in_bounds < 0 && !compiled_cones.is_empty() && !direction.is_zero_approx()) {
+				// The limiting basis may carry scale, and Quaternion(from, to) expects unit vectors.
+				Vector3 constrained_direction = twist_center_inverse.xform(limiting_global.basis.xform(in_limits)).normalized();
+				align_rot = (Quaternion(direction, constrained_direction) * align_rot).normalized();
+				snap_count++;
+			}
+		}
+	}
+
+	if (is_axially_constrained()) {
+		Quaternion swing_rotation, twist_rotation;
+		get_swing_twist(align_rot, Vector3(0, 1, 0), swing_rotation, twist_rotation);
+		if (Math::abs(twist_rotation.w) < twist_half_range_half_cos) {
+			twist_rotation = IKBoneSegment3D::clamp_to_cos_half_angle(twist_rotation, twist_half_range_half_cos);
+			align_rot = swing_rotation * twist_rotation;
+			snap_count++;
+		}
+	}
+
+	if (snap_count == 0) {
+		return 0;
+	}
+	Basis rotation = p_frames.parent_inverse * Basis(p_frames.twist_center * align_rot);
+	p_store->set_transform(p_to_set, Transform3D(rotation, p_store->get_transform(p_to_set).origin));
+	return snap_count;
+}
+
+uint32_t IKKusudama3D::apply_resistance(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, const IKConstraintFrames3D &p_frames, double p_angle, double p_cos_half_angle) {
+	ERR_FAIL_NULL_V(p_store, 0);
+	if (p_bone_direction == -1 || p_to_set == -1 || p_angle <= 0.0) {
+		return 0;
+	}
+
+	const Quaternion &twist_center_inverse = p_frames.twist_center_inverse;
+	Quaternion align_rot = (twist_center_inverse * p_store->get_global_transform(p_to_set).basis.get_rotation_quaternion()).normalized();
+	uint32_t pull_count = 0;
+
+	if (is_orientationally_constrained() && !compiled_cones.is_empty()) {
+		const Transform3D &limiting_global = p_frames.limiting;
+		Vector3 heading = p_store->get_global_transform(p_bone_direction).xform(Vector3(0, 1, 0)) - limiting_global.origin;
+		Vector3 local_heading = p_frames.limiting_inverse.xform(heading);
+		if (!local_heading.is_zero_approx()) {
+			Vector3 comfort_point = _get_comfort_point(local_heading.normalized());
+			Vector3 direction = twist_center_inverse.xform(heading).normalized();
+			Vector3 comfort_direction = twist_center_inverse.xform(limiting_global.basis.xform(comfort_point)).normalized();
+			if (direction.dot(comfort_direction) < 1.0 - CMP_EPSILON) {
+				Quaternion pull = IKBoneSegment3D::clamp_to_cos_half_angle(Quaternion(direction, comfort_direction), p_cos_half_angle);
+				align_rot = (pull * align_rot).normalized();
+				pull_count++;
+			}
+		}
+	}
+
+	if (is_axially_constrained()) {
+		// The middle of the twist range is the identity in the twist center frame.
+		Quaternion swing_rotation, twist_rotation;
+		get_swing_twist(align_rot, Vector3(0, 1, 0), swing_rotation, twist_rotation);
+		if (Math::abs(twist_rotation.w) < 1.0 - CMP_EPSILON) {
+			twist_rotation = twist_rotation * IKBoneSegment3D::clamp_to_cos_half_angle(twist_rotation.inverse(), p_cos_half_angle);
+			align_rot = swing_rotation * twist_rotation;
+			pull_count++;
+		}
+	}
+
+	if (pull_count == 0) {
+		return 0;
+	}
+	Basis rotation = p_frames.parent_inverse * Basis(p_frames.twist_center * align_rot);
+	p_store->set_transform(p_to_set, Transform3D(rotation, p_store->get_transform(p_to_set).origin));
+	return pull_count;
+}
+
+Vector3 IKKusudama3D::_get_comfort_point(const Vector3 &p_point) const {
+	// The closest point to p_point on the spine of the limits, which runs through the control points along the great
+	// arcs joining consecutive cones.
+	Vector3 result = compiled_cones[0].control_point;
+	double result_dot = result.dot(p_point);
+	for (uint32_t cone_i = 1; cone_i < compiled_cones.size(); cone_i++) {
+		const Vector3 &previous_point = compiled_cones[cone_i - 1].control_point;
+		const Vector3 &control_point = compiled_cones[cone_i].control_point;
+		double control_dot = control_point.dot(p_point);
+		if (control_dot > result_dot) {
+			result = control_point;
+			result_dot = control_dot;
+		}
+		const Vector3 &normal = compiled_cone_pairs[cone_i - 1].control_cross;
+		double normal_length_squared = normal.length_squared();
+		if (normal_length_squared < CMP_EPSILON2) {
+			continue;
+		}
+		Vector3 on_arc = p_point - normal * (p_point.dot(normal) / normal_length_squared);
+		if (on_arc.is_zero_approx()) {
+			continue;
+		}
+		on_arc.normalize();
+		if (previous_point.cross(on_arc).dot(normal) < 0.0 || on_arc.cross(control_point).dot(normal) < 0.0) {
+			continue;
+		}
+		double arc_dot = on_arc.dot(p_point);
+		if (arc_dot > result_dot) {
+			result = on_arc;
+			result_dot = arc_dot;
+		}
 	}
-	Transform3D global_transform_constraint = p_constraint_axes->get_global_transform();
-	Transform3D global_transform_to_set = p_to_set->get_global_transform();
-	Basis parent_global_inverse = p_to_set->get_parent()->get_global_transform().basis.inverse();
-	Basis global_twist_center = global_transform_constraint.basis * twist_center_rot;
-	Basis align_rot = (global_twist_center.inverse() * global_transform_to_set.basis).orthonormalized();
-	Quaternion twist_rotation, swing_rotation; // Hold the ik transform's decomposed swing and twist away from global_twist_centers's global basis.
-	get_swing_twist(align_rot.get_rotation_quaternion(), Vector3(0, 1, 0), swing_rotation, twist_rotation);
-	twist_rotation = IKBoneSegment3D::clamp_to_cos_half_angle(twist_rotation, twist_half_range_half_cos);
-	Basis recomposition = (global_twist_center * (swing_rotation * twist_rotation)).orthonormalized();
-	Basis rotation = parent_global_inverse * recomposition;
-	p_to_set->set_transform(Transform3D(rotation, p_to_set->get_transform().origin));
+	return result;
 }
 
 void IKKusudama3D::get_swing_twist(
@@ -169,21 +470,22 @@ void IKKusudama3D::add_open_cone(
 void IKKusudama3D::remove_open_cone(Ref<IKLimitCone3D> limitCone) {
 	ERR_FAIL_COND(limitCone.is_null());
 	open_cones.erase(limitCone);
+	update_tangent_radii();
 }
 
 real_t IKKusudama3D::get_min_axial_angle() {
 	return min_axial_angle;
 }
 
-real_t IKKusudama3D::get_range_angle() {
+real_t IKKusudama3D::get_range_angle() const {
 	return range_angle;
 }
 
-bool IKKusudama3D::is_axially_constrained() {
+bool IKKusudama3D::is_axially_constrained() const {
 	return axially_constrained;
 }
 
-bool IKKusudama3D::is_orientationally_constrained() {
+bool IKKusudama3D::is_orientationally_constrained() const {
 	return orientationally_constrained;
 }
 
@@ -233,31 +535,6 @@ TypedArray<IKLimitCone3D> IKKusudama3D::get_open_cones() const {
 	return cones;
 }
 
-Vector3 IKKusudama3D::local_point_on_path_sequence(Vector3 p_in_point, Ref<IKNode3D> p_limiting_axes) {
-	double closest_point_dot = 0;
-	Vector3 point = p_limiting_axes->get_transform().xform(p_in_point);
-	point.normalize();
-	Vector3 result = point;
-
-	if (open_cones.size() == 1) {
-		Ref<IKLimitCone3D> cone = open_cones[0];
-		result = cone->get_control_point();
-	} else {
-		for (int i = 0; i < open_cones.size() - 1; i++) {
-			Ref<IKLimitCone3D> next_cone = open_cones[i + 1];
-			Ref<IKLimitCone3D> cone = open_cones[i];
-			Vector3 closestPathPoint = cone->get_closest_path_point(next_cone, point);
-			double closeDot = closestPathPoint.dot(point);
-			if (closeDot > closest_point_dot) {
-				result = closestPathPoint;
-				closest_point_dot = closeDot;
-			}
-		}
-	}
-
-	return result;
-}
-
 /**
  * Given a point (in global coordinates), checks to see if a ray can be extended from the Kusudama's
  * origin to that point, such that the ray in the Kusudama's reference frame is within the range_angle allowed by the Kusudama's
@@ -271,70 +548,89 @@ Vector3 IKKusudama3D::local_point_on_path_sequence(Vector3 p_in_point, Ref<IKNod
  * the point is outside of the boundary, but does not signify anything about how far from the boundary the point is.
  * @return the original point, if it's in limits, or the closest point which is in limits.
  */
-Vector3 IKKusudama3D::get_local_point_in_limits(Vector3 in_point, Vector<double> *in_bounds) {
-	// Normalize the input point
-	Vector3 point = in_point.normalized();
-	real_t closest_cos = -2.0;
-	in_bounds->write[0] = -1;
-
-	Vector3 closest_collision_point = in_point;
-
-	// Loop through each limit cone
-	for (int i = 0; i < open_cones.size(); i++) {
-		Ref<IKLimitCone3D> cone = open_cones[i];
-		Vector3 collision_point = cone->closest_to_cone(point, in_bounds);
+Vector3 IKKusudama3D::get_local_point_in_limits(Vector3 in_point, Vector<double> *in_bounds) const {
+	ERR_FAIL_NULL_V(in_bounds, in_point);
+	ERR_FAIL_COND_V(in_bounds->is_empty(), in_point);
+	double bounds = -1;
+	Vector3 result = get_local_point_in_limits(in_point, bounds);
+	in_bounds->write[0] = bounds;
+	return result;
+}
 
-		// If the collision point is NaN, return the original point
-		if (Math::is_nan(collision_point.x) || Math::is_nan(collision_point.y) || Math::is_nan(collision_point.z)) {
-			in_bounds->write[0] = 1;
+Vector3 IKKusudama3D::get_local_point_in_limits(const Vector3 &p_in_point, double &r_in_bounds) const {
+	Vector3 point = p_in_point.normalized();
+	r_in_bounds = -1;
+	if (compiled_cones.is_empty()) {
+		return p_in_point;
+	}
+	if (!bounds_grid.is_empty() && !point.is_zero_approx()) {
+		int32_t cell = _get_bounds_grid_cell(point);
+		if (bounds_grid[cell >> 5] & (1u << (cell & 31))) {
+			r_in_bounds = 1;
 			return point;
 		}
+	}
 
-		// Calculate the cosine of the angle between the collision point and the original point
-		real_t this_cos = collision_point.dot(point);
-
-		// If the closest collision point is not set or the cosine is greater than the current closest cosine, update the closest collision point and cosine
-		if (closest_collision_point.is_zero_approx() || this_cos > closest_cos) {
-			closest_collision_point = collision_point;
+	// The cosine between the point and its projection onto a boundary circle of angular radius r is
+	// cos(angle - r), so the candidates are ranked from a dot product alone and only the winner is built.
+	const CompiledCone *closest_cone = nullptr;
+	double closest_cos = -2.0;
+	for (const CompiledCone &cone : compiled_cones) {
+		double to_control = point.dot(cone.control_point);
+		if (to_control > cone.radius_cosine) {
+			r_in_bounds = 1;
+			return point;
+		}
+		double this_cos = cone.radius_cosine * to_control + cone.radius_sine * Math::sqrt(MAX(0.0, 1.0 - to_control * to_control));
+		if (this_cos > closest_cos) {
+			closest_cone = &cone;
 			closest_cos = this_cos;
 		}
 	}
 
-	// If we're out of bounds of all cones, check if we're in the paths between the cones
-	if ((*in_bounds)[0] == -1) {
-		for (int i = 0; i < open_cones.size() - 1; i++) {
-			Ref<IKLimitCone3D> currCone = open_cones[i];
-			Ref<IKLimitCone3D> nextCone = open_cones[i + 1];
-			Vector3 collision_point = currCone->get_on_great_tangent_triangle(nextCone, point);
-
-			// If the collision point is NaN, skip to the next iteration
-			if (Math::is_nan(collision_point.x)) {
-				continue;
-			}
-
-			real_t this_cos = collision_point.dot(point);
-
-			// If the cosine is approximately 1, return the original point
-			if (Math::is_equal_approx(this_cos, real_t(1.0))) {
-				in_bounds->write[0] = 1;
-				return point;
-			}
-
-			// If the cosine is greater than the current closest cosine, update the closest collision point and cosine
-			if (this_cos > closest_cos) {
-				closest_collision_point = collision_point;
-				closest_cos = this_cos;
-			}
+	// Out of bounds of all cones, so check the paths between them.
+	const CompiledConePair *closest_pair = nullptr;
+	int32_t closest_side = 0;
+	for (const CompiledConePair &pair : compiled_cone_pairs) {
+		int32_t side = point.dot(pair.control_cross) < 0.0 ? 0 : 1;
+		if (point.dot(pair.boundary_normals[side][0]) <= 0 || point.dot(pair.boundary_normals[side][1]) <= 0) {
+			continue;
+		}
+		double to_tangent = point.dot(pair.tangent_centers[side]);
+		if (to_tangent <= pair.tangent_radius_cosine) {
+			r_in_bounds = 1;
+			return point;
+		}
+		// Inside the tangent circle, so the nearest allowed direction is on its rim.
+		double this_cos = pair.tangent_radius_cosine * to_tangent + pair.tangent_radius_sine * Math::sqrt(MAX(0.0, 1.0 - to_tangent * to_tangent));
+		if (Math::is_equal_approx(this_cos, 1.0)) {
+			r_in_bounds = 1;
+			return point;
+		}
+		if (this_cos > closest_cos) {
+			closest_pair = &pair;
+			closest_side = side;
+			closest_cos = this_cos;
 		}
 	}
 
-	// Return the closest boundary point between cones
-	return closest_collision_point;
+	if (closest_pair) {
+		return _rotate_toward(closest_pair->tangent_centers[closest_side], point, closest_pair->tangent_radius, closest_pair->tangent_radius_cosine, closest_pair->tangent_radius_sine);
+	}
+	return _rotate_toward(closest_cone->control_point, point, closest_cone->radius, closest_cone->radius_cosine, closest_cone->radius_sine);
 }
 
 void IKKusudama3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_open_cones"), &IKKusudama3D::get_open_cones);
 	ClassDB::bind_method(D_METHOD("set_open_cones", "open_cones"), &IKKusudama3D::set_open_cones);
+	ClassDB::bind_method(D_METHOD("set_bounds_grid_resolution", "resolution"), &IKKusudama3D::set_bounds_grid_resolution);
+	ClassDB::bind_method(D_METHOD("get_bounds_grid_resolution"), &IKKusudama3D::get_bounds_grid_resolution);
+	ClassDB::bind_method(D_METHOD("get_bounds_grid_memory_usage"), &IKKusudama3D::get_bounds_grid_memory_usage);
+	ClassDB::bind_method(D_METHOD("set_resistance", "resistance"), &IKKusudama3D::set_resistance);
+	ClassDB::bind_method(D_METHOD("get_resistance"), &IKKusudama3D::get_resistance);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "bounds_grid_resolution", PROPERTY_HINT_RANGE, "0,1024,2"), "set_bounds_grid_resolution", "get_bounds_grid_resolution");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "resistance", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_resistance", "get_resistance");
 }
 
 void IKKusudama3D::set_open_cones(TypedArray<IKLimitCone3D> p_cones) {
@@ -343,37 +639,7 @@ void IKKusudama3D::set_open_cones(TypedArray<IKLimitCone3D> p_cones) {
 	for (int32_t i = 0; i < p_cones.size(); i++) {
 		open_cones.write[i] = p_cones[i];
 	}
-}
-
-void IKKusudama3D::snap_to_orientation_limit(Ref<IKNode3D> bone_direction, Ref<IKNode3D> to_set, Ref<IKNode3D> limiting_axes, real_t p_dampening, real_t p_cos_half_angle_dampen) {
-	if (bone_direction.is_null()) {
-		return;
-	}
-	if (to_set.is_null()) {
-		return;
-	}
-	if (limiting_axes.is_null()) {
-		return;
-	}
-	Vector<double> in_bounds;
-	in_bounds.resize(1);
-	in_bounds.write[0] = 1.0;
-	Vector3 limiting_origin = limiting_axes->get_global_transform().origin;
-	Vector3 bone_dir_xform = bone_direction->get_global_transform().xform(Vector3(0.0, 1.0, 0.0));
-
-	bone_ray->set_point_1(limiting_origin);
-	bone_ray->set_point_2(bone_dir_xform);
-
-	Vector3 bone_tip = limiting_axes->to_local(bone_ray->get_point_2());
-	Vector3 in_limits = get_local_point_in_limits(bone_tip, &in_bounds);
-
-	if (in_bounds[0] < 0) {
-		constrained_ray->set_point_1(bone_ray->get_point_1());
-		constrained_ray->set_point_2(limiting_axes->to_global(in_limits));
-
-		Quaternion rectified_rot = Quaternion(bone_ray->get_heading(), constrained_ray->get_heading());
-		to_set->rotate_local_with_global(rectified_rot);
-	}
+	update_tangent_radii();
 }
 
 bool IKKusudama3D::is_nan_vector(const Vector3 &vec) {
@@ -381,7 +647,7 @@ bool IKKusudama3D::is_nan_vector(const Vector3 &vec) {
 }
 
 void IKKusudama3D::set_resistance(float p_resistance) {
-	resistance = p_resistance;
+	resistance = CLAMP(p_resistance, 0.0f, 1.0f);
 }
 
 float IKKusudama3D::get_resistance() {
@@ -413,6 +679,7 @@ Quaternion IKKusudama3D::clamp_to_quadrance_angle(Quaternion p_rotation, double
 
 void IKKusudama3D::clear_open_cones() {
 	open_cones.clear();
+	update_tangent_radii();
 }
 
 Quaternion IKKusudama3D::get_quaternion_axis_angle(const Vector3 &p_axis, real_t p_angle) {
@@ -33,13 +33,15 @@
 
 #include "ik_bone_3d.h"
 #include "ik_bone_segment_3d.h"
+#include "ik_constraint_frames_3d.h"
 #include "ik_open_cone_3d.h"
-#include "ik_ray_3d.h"
 #include "math/ik_node_3d.h"
+#include "math/ik_transform_store_3d.h"
 
 #include "core/io/resource.h"
 #include "core/math/quaternion.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 #include "scene/3d/node_3d.h"
 
@@ -55,6 +57,51 @@ class IKKusudama3D : public Resource {
 	 */
 	Vector<Ref<IKLimitCone3D>> open_cones;
 
+	/**
+	 * A flattened copy of open_cones used by get_local_point_in_limits(). update_tangent_radii() rebuilds it
+	 * whenever the cones change, so the queries stay read only and the snap path walks contiguous memory instead
+	 * of dereferencing every cone and renormalizing and recomputing the same cross products on every query.
+	 */
+	struct CompiledCone {
+		Vector3 control_point;
+		double radius = 0;
+		double radius_cosine = 1;
+		double radius_sine = 0;
+		double radius_half_cosine = 1;
+	};
+
+	/**
+	 * The path between a cone and the next one. Index 0 holds the side of the great arc facing
+	 * tangent_circle_center_next_1, index 1 the side facing tangent_circle_center_next_2.
+	 */
+	struct CompiledConePair {
+		Vector3 control_cross;
+		Vector3 tangent_centers[2];
+		Vector3 boundary_normals[2][2];
+		double tangent_radius = 0;
+		double tangent_radius_cosine = 1;
+		double tangent_radius_sine = 0;
+	};
+
+	LocalVector<CompiledCone> compiled_cones;
+	LocalVector<CompiledConePair> compiled_cone_pairs;
+	bool single_cone = false; // Set when the cones are compiled, so the snap path picks its branch without looking at them.
+
+	/**
+	 * Optional octahedral map of the sphere, bounds_grid_resolution cells on a side, with one bit per cell.
+	 * A set bit means the whole cell lies inside one of the cones, so a point falling in it is in bounds without
+	 * any further test. Cells touching a boundary, the paths between cones, or the outside stay clear and take the
+	 * exact path.
+	 */
+	int32_t bounds_grid_resolution = 0;
+	LocalVector<uint32_t> bounds_grid;
+
+	void _compile_open_cones();
+	void _build_bounds_grid();
+	int32_t _get_bounds_grid_cell(const Vector3 &p_direction) const;
+	Vector3 _get_comfort_point(const Vector3 &p_point) const;
+	static Vector3 _rotate_toward(const Vector3 &p_from, const Vector3 &p_toward, double p_angle, double p_cos, double p_sin);
+
 	Quaternion twist_min_rot;
 	Vector3 twist_min_vec;
 	Vector3 twist_max_vec;
@@ -92,8 +139,12 @@ public:
 
 	void update_tangent_radii();
 
-	Ref<IKRay3D> bone_ray = Ref<IKRay3D>(memnew(IKRay3D()));
-	Ref<IKRay3D> constrained_ray = Ref<IKRay3D>(memnew(IKRay3D()));
+	/**
+	 * Refreshes the tangents and the compiled cone data. Called by the cones themselves when one of their
+	 * parameters changes after they were added.
+	 */
+	void notify_open_cones_changed();
+
 	double unit_hyper_area = 2 * Math::pow(Math_PI, 2);
 	double unit_area = 4 * Math_PI;
 
@@ -116,14 +167,6 @@ public:
 	static Quaternion get_quaternion_axis_angle(const Vector3 &p_axis, real_t p_angle);
 
 public:
-	/**
-	 * Presumes the input axes are the bone's localAxes, and rotates
-	 * them to satisfy the snap limits.
-	 *
-	 * @param to_set
-	 */
-	void snap_to_orientation_limit(Ref<IKNode3D> p_bone_direction, Ref<IKNode3D> p_to_set, Ref<IKNode3D> p_limiting_axes, real_t p_dampening, real_t p_cos_half_angle_dampen);
-
 	bool is_nan_vector(const Vector3 &vec);
 
 	/**
@@ -140,12 +183,61 @@ public:
 	void set_axial_limits(real_t p_min_angle, real_t p_in_range);
 
 	/**
+	 * True when the kusudama has exactly one open cone, which is the common case for elbows, knees and fingers.
+	 * apply_limits() clamps the swing of such constraints in closed form instead of searching the cones and paths.
+	 */
+	bool is_single_cone() const;
+
+	int32_t get_compiled_cone_count() const;
+
+	/**
+	 * The control point and the cosine of the radius of a cone, as compiled by update_tangent_radii().
+	 */
+	void get_compiled_cone(int32_t p_index, Vector3 &r_control_point, double &r_radius_cosine) const;
+
+	/**
+	 * Presumes the input axes are the bone's local axes, and rotates them to satisfy the orientation and twist
+	 * limits together. The transforms are addressed by their handles in the segment tree's transform store.
+	 * The bone rotation is taken into the twist center frame once, the swing is clamped there (directly on the quaternion for a single cone), the twist is clamped from the same swing-twist
+	 * decomposition, and the result is written back with a single set_transform().
 	 *
-	 * @param to_set
-	 * @param limiting_axes
-	 * @return radians of the twist required to snap bone into twist limits (0 if bone is already in twist limits)
+	 * @return the number of limits that had to be enforced, from 0 to 2.
+	 */
+	uint32_t apply_limits(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, int32_t p_limiting_axes, int32_t p_twist_axes);
+
+	/**
+	 * Same as above with the limiting frames already computed by compute_constraint_frames(). The solver keeps them
+	 * per bone, since they stay valid for as long as the bone's parent does not move.
+	 */
+	uint32_t apply_limits(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, const IKConstraintFrames3D &p_frames);
+
+	/**
+	 * Computes the global limiting frames from the parent's global transform and the frames' local transforms,
+	 * without refreshing the frames' own entries in the transform store. Only reads the store once the parent is
+	 * clean, so sibling segments may call it concurrently on a shared parent.
+	 */
+	void compute_constraint_frames(const IKTransformStore3D *p_store, int32_t p_to_set, int32_t p_limiting_axes, int32_t p_twist_axes, IKConstraintFrames3D &r_frames) const;
+
+	/**
+	 * Same as above from the limiting and twist axes given in any space shared with the bone, usually its parent's.
+	 * parent_inverse is left as the identity.
 	 */
-	void set_snap_to_twist_limit(Ref<IKNode3D> p_bone_direction, Ref<IKNode3D> p_to_set, Ref<IKNode3D> p_limiting_axes, real_t p_dampening, real_t p_cos_half_dampen);
+	void compute_constraint_frames(const Transform3D &p_limiting_axes, const Transform3D &p_twist_axes, IKConstraintFrames3D &r_frames) const;
+
+	/**
+	 * Measures how far a bone is outside the limits without changing it. p_bone_basis and p_tip, the point the bone
+	 * direction reaches, are in the same space as p_frames. r_swing receives the angle between the bone heading and the
+	 * nearest allowed one, r_twist the angle past the twist range. Both are 0 within the limits.
+	 */
+	void get_limit_violation(const IKConstraintFrames3D &p_frames, const Basis &p_bone_basis, const Vector3 &p_tip, real_t &r_swing, real_t &r_twist) const;
+
+	/**
+	 * Soft limit. Rotates the bone at most p_angle back toward the comfort region of the constraint: the control
+	 * points and the arcs joining consecutive ones for the swing, and the middle of the twist range for the twist.
+	 * Meant to run every iteration with the bone's resistance tables, before the hard limits are applied.
+	 * @return the number of corrections applied, 0 when the bone was already at rest.
+	 */
+	uint32_t apply_resistance(IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, const IKConstraintFrames3D &p_frames, double p_angle, double p_cos_half_angle);
 
 	/**
 	 * Given a point (in local coordinates), checks to see if a ray can be extended from the Kusudama's
@@ -162,9 +254,12 @@ public:
 	 * this value will be set to a non-integer value between the two indices of the limitcone comprising the segment whose bounds were exceeded.
 	 * @return the original point, if it's in limits, or the closest point which is in limits.
 	 */
-	Vector3 get_local_point_in_limits(Vector3 in_point, Vector<double> *in_bounds);
+	Vector3 get_local_point_in_limits(Vector3 in_point, Vector<double> *in_bounds) const;
 
-	Vector3 local_point_on_path_sequence(Vector3 in_point, Ref<IKNode3D> limiting_axes);
+	/**
+	 * Same as above, with the boundary value written to a plain scalar so the solver path never allocates.
+	 */
+	Vector3 get_local_point_in_limits(const Vector3 &p_in_point, double &r_in_bounds) const;
 
 	/**
 	 * Add a IKLimitCone to the Kusudama.
@@ -179,10 +274,10 @@ public:
 	 * @return the lower bound on the axial constraint
 	 */
 	real_t get_min_axial_angle();
-	real_t get_range_angle();
+	real_t get_range_angle() const;
 
-	bool is_axially_constrained();
-	bool is_orientationally_constrained();
+	bool is_axially_constrained() const;
+	bool is_orientationally_constrained() const;
 	void disable_orientational_limits();
 	void enable_orientational_limits();
 	void toggle_orientational_limits();
@@ -197,6 +292,14 @@ public:
 	void set_open_cones(TypedArray<IKLimitCone3D> p_cones);
 	float get_resistance();
 	void set_resistance(float p_resistance);
+
+	/**
+	 * Sets the number of cells on each side of the in-bounds grid. 0 disables the grid. Other values are clamped
+	 * to [4, 1024] and rounded up to an even number, so that the octahedral folds run along cell edges and diagonals.
+	 */
+	void set_bounds_grid_resolution(int32_t p_resolution);
+	int32_t get_bounds_grid_resolution() const;
+	int64_t get_bounds_grid_memory_usage() const;
 	static Quaternion clamp_to_quadrance_angle(Quaternion p_rotation, double p_cos_half_angle);
 };
 
@@ -32,6 +32,7 @@
 
 #include "core/math/quaternion.h"
 #include "ik_kusudama_3d.h"
+#include "ik_ray_3d.h"
 
 void IKLimitCone3D::update_tangent_handles(Ref<IKLimitCone3D> p_next) {
 	if (p_next.is_null()) {
@@ -88,22 +89,23 @@ void IKLimitCone3D::update_tangent_handles(Ref<IKLimitCone3D> p_next) {
 	Vector3 planeDir2B = tempVar4.xform(planeDir1B);
 
 	// ray from scaled center of next cone to half way point between the circumference of this cone and the next cone.
-	Ref<IKRay3D> r1B = Ref<IKRay3D>(memnew(IKRay3D(planeDir1B, scaledAxisB)));
-	Ref<IKRay3D> r2B = Ref<IKRay3D>(memnew(IKRay3D(planeDir1B, planeDir2B)));
+	Vector3 r1B_point_1 = planeDir1B;
+	Vector3 r1B_point_2 = scaledAxisB;
+	Vector3 r2B_point_1 = planeDir1B;
+	Vector3 r2B_point_2 = planeDir2B;
 
-	r1B->elongate(99);
-	r2B->elongate(99);
+	IKRay3D::elongate_points(r1B_point_1, r1B_point_2, 99);
+	IKRay3D::elongate_points(r2B_point_1, r2B_point_2, 99);
 
-	Vector3 intersection1 = r1B->get_intersects_plane(scaledAxisA, planeDir1A, planeDir2A);
-	Vector3 intersection2 = r2B->get_intersects_plane(scaledAxisA, planeDir1A, planeDir2A);
+	Vector3 intersection1 = IKRay3D::intersect_plane_points(r1B_point_1, r1B_point_2, scaledAxisA, planeDir1A, planeDir2A);
+	Vector3 intersection2 = IKRay3D::intersect_plane_points(r2B_point_1, r2B_point_2, scaledAxisA, planeDir1A, planeDir2A);
 
-	Ref<IKRay3D> intersectionRay = Ref<IKRay3D>(memnew(IKRay3D(intersection1, intersection2)));
-	intersectionRay->elongate(99);
+	IKRay3D::elongate_points(intersection1, intersection2, 99);
 
 	Vector3 sphereIntersect1;
 	Vector3 sphereIntersect2;
 	Vector3 sphereCenter;
-	intersectionRay->intersects_sphere(sphereCenter, 1.0f, &sphereIntersect1, &sphereIntersect2);
+	IKRay3D::intersect_sphere_points(intersection1, intersection2, sphereCenter, 1.0f, &sphereIntersect1, &sphereIntersect2);
 
 	set_tangent_circle_center_next_1(sphereIntersect1);
 	set_tangent_circle_center_next_2(sphereIntersect2);
@@ -122,6 +124,7 @@ void IKLimitCone3D::update_tangent_handles(Ref<IKLimitCone3D> p_next) {
 void IKLimitCone3D::set_tangent_circle_radius_next(double rad) {
 	tangent_circle_radius_next = rad;
 	tangent_circle_radius_next_cos = cos(tangent_circle_radius_next);
+	_notify_attached_changed();
 }
 
 Vector3 IKLimitCone3D::get_tangent_circle_center_next_1() {
@@ -164,6 +167,7 @@ void IKLimitCone3D::set_control_point(Vector3 p_control_point) {
 		control_point = p_control_point;
 		control_point.normalize();
 	}
+	_notify_attached_changed();
 }
 
 double IKLimitCone3D::get_radius() const {
@@ -177,6 +181,7 @@ double IKLimitCone3D::get_radius_cosine() const {
 void IKLimitCone3D::set_radius(double p_radius) {
 	radius = p_radius;
 	radius_cosine = cos(p_radius);
+	_notify_attached_changed();
 }
 
 bool IKLimitCone3D::_determine_if_in_bounds(Ref<IKLimitCone3D> next, Vector3 input) const {
@@ -251,13 +256,12 @@ Vector3 IKLimitCone3D::_get_closest_collision(Ref<IKLimitCone3D> next, Vector3 i
 	ERR_FAIL_COND_V(next.is_null(), input);
 	Vector3 result;
 	if (next.is_null()) {
-		Vector<double> in_bounds = { 0.0 };
 		result = _closest_cone(Ref<IKLimitCone3D>(), input);
 	} else {
 		result = get_on_great_tangent_triangle(next, input);
 		bool is_number = !(Math::is_nan(result.x) && Math::is_nan(result.y) && Math::is_nan(result.z));
 		if (!is_number) {
-			Vector<double> in_bounds = { 0.0 };
+			double in_bounds = 0.0;
 			result = _closest_point_on_closest_cone(next, input, &in_bounds);
 		}
 	}
@@ -331,17 +335,17 @@ Vector3 IKLimitCone3D::_closest_cone(Ref<IKLimitCone3D> next, Vector3 input) con
 	}
 }
 
-Vector3 IKLimitCone3D::_closest_point_on_closest_cone(Ref<IKLimitCone3D> next, Vector3 input, Vector<double> *in_bounds) const {
+Vector3 IKLimitCone3D::_closest_point_on_closest_cone(Ref<IKLimitCone3D> next, Vector3 input, double *in_bounds) const {
 	ERR_FAIL_COND_V(next.is_null(), input);
 	Vector3 closestToFirst = closest_to_cone(input, in_bounds);
-	if (in_bounds != nullptr && (*in_bounds)[0] > 0.0) {
+	if (in_bounds != nullptr && *in_bounds > 0.0) {
 		return closestToFirst;
 	}
 	if (next.is_null()) {
 		return closestToFirst;
 	} else {
 		Vector3 closestToSecond = next->closest_to_cone(input, in_bounds);
-		if (in_bounds != nullptr && (*in_bounds)[0] > 0.0) {
+		if (in_bounds != nullptr && *in_bounds > 0.0) {
 			return closestToSecond;
 		}
 		double cosToFirst = input.dot(closestToFirst);
@@ -355,12 +359,12 @@ Vector3 IKLimitCone3D::_closest_point_on_closest_cone(Ref<IKLimitCone3D> next, V
 	}
 }
 
-Vector3 IKLimitCone3D::closest_to_cone(Vector3 input, Vector<double> *in_bounds) const {
+Vector3 IKLimitCone3D::closest_to_cone(Vector3 input, double *in_bounds) const {
 	Vector3 normalized_input = input.normalized();
 	Vector3 normalized_control_point = get_control_point().normalized();
 	if (normalized_input.dot(normalized_control_point) > get_radius_cosine()) {
 		if (in_bounds != nullptr) {
-			in_bounds->write[0] = 1.0;
+			*in_bounds = 1.0;
 		}
 		return Vector3(NAN, NAN, NAN);
 	}
@@ -375,17 +379,19 @@ Vector3 IKLimitCone3D::closest_to_cone(Vector3 input, Vector<double> *in_bounds)
 	}
 	Vector3 result = rot_to.xform(axis_control_point);
 	if (in_bounds != nullptr) {
-		in_bounds->write[0] = -1;
+		*in_bounds = -1;
 	}
 	return result;
 }
 
 void IKLimitCone3D::set_tangent_circle_center_next_1(Vector3 point) {
 	tangent_circle_center_next_1 = point.normalized();
+	_notify_attached_changed();
 }
 
 void IKLimitCone3D::set_tangent_circle_center_next_2(Vector3 point) {
 	tangent_circle_center_next_2 = point.normalized();
+	_notify_attached_changed();
 }
 
 Vector3 IKLimitCone3D::_get_on_path_sequence(Ref<IKLimitCone3D> next, Vector3 input) const {
@@ -398,8 +404,7 @@ Vector3 IKLimitCone3D::_get_on_path_sequence(Ref<IKLimitCone3D> next, Vector3 in
 		Vector3 c1xt1 = get_control_point().cross(tangent_circle_center_next_1).normalized();
 		Vector3 t1xc2 = tangent_circle_center_next_1.cross(next->get_control_point()).normalized();
 		if (input.dot(c1xt1) > 0.0f && input.dot(t1xc2) > 0.0f) {
-			Ref<IKRay3D> tan1ToInput = Ref<IKRay3D>(memnew(IKRay3D(tangent_circle_center_next_1, input)));
-			Vector3 result = tan1ToInput->get_intersects_plane(Vector3(0.0f, 0.0f, 0.0f), get_control_point(), next->get_control_point());
+			Vector3 result = IKRay3D::intersect_plane_points(tangent_circle_center_next_1, input, Vector3(0.0f, 0.0f, 0.0f), get_control_point(), next->get_control_point());
 			return result.normalized();
 		} else {
 			return Vector3(NAN, NAN, NAN);
@@ -408,8 +413,7 @@ Vector3 IKLimitCone3D::_get_on_path_sequence(Ref<IKLimitCone3D> next, Vector3 in
 		Vector3 t2xc1 = tangent_circle_center_next_2.cross(control_point).normalized();
 		Vector3 c2xt2 = next->get_control_point().cross(tangent_circle_center_next_2).normalized();
 		if (input.dot(t2xc1) > 0 && input.dot(c2xt2) > 0) {
-			Ref<IKRay3D> tan2ToInput = Ref<IKRay3D>(memnew(IKRay3D(tangent_circle_center_next_2, input)));
-			Vector3 result = tan2ToInput->get_intersects_plane(Vector3(0.0f, 0.0f, 0.0f), get_control_point(), next->get_control_point());
+			Vector3 result = IKRay3D::intersect_plane_points(tangent_circle_center_next_2, input, Vector3(0.0f, 0.0f, 0.0f), get_control_point(), next->get_control_point());
 			return result.normalized();
 		} else {
 			return Vector3(NAN, NAN, NAN);
@@ -424,3 +428,10 @@ void IKLimitCone3D::set_attached_to(Ref<IKKusudama3D> p_attached_to) {
 Ref<IKKusudama3D> IKLimitCone3D::get_attached_to() {
 	return parent_kusudama.get_ref();
 }
+
+void IKLimitCone3D::_notify_attached_changed() {
+	Ref<IKKusudama3D> kusudama = get_attached_to();
+	if (kusudama.is_valid()) {
+		kusudama->notify_open_cones_changed();
+	}
+}
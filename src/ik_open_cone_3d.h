@@ -92,10 +92,13 @@ class IKLimitCone3D : public Resource {
 	 * @param in_bounds
 	 * @return
 	 */
-	Vector3 _closest_point_on_closest_cone(Ref<IKLimitCone3D> next, Vector3 input, Vector<double> *in_bounds) const;
+	Vector3 _closest_point_on_closest_cone(Ref<IKLimitCone3D> next, Vector3 input, double *in_bounds) const;
 
 	double _get_tangent_circle_radius_next_cos();
 
+	// Lets the kusudama this cone is attached to know its compiled cone data is stale.
+	void _notify_attached_changed();
+
 public:
 	IKLimitCone3D() {}
 	virtual ~IKLimitCone3D() {}
@@ -122,7 +125,7 @@ public:
 	 * @param in_bounds
 	 * @return
 	 */
-	Vector3 closest_to_cone(Vector3 input, Vector<double> *in_bounds) const;
+	Vector3 closest_to_cone(Vector3 input, double *in_bounds) const;
 	Vector3 get_closest_path_point(Ref<IKLimitCone3D> next, Vector3 input) const;
 	Vector3 get_control_point() const;
 	void set_control_point(Vector3 p_control_point);
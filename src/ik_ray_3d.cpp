@@ -62,37 +62,59 @@ real_t IKRay3D::get_scaled_projection(const Vector3 p_input) {
 }
 
 void IKRay3D::elongate(real_t amt) {
-	Vector3 midPoint = (point_1 + point_2) * 0.5f;
-	Vector3 p1Heading = point_1 - midPoint;
-	Vector3 p2Heading = point_2 - midPoint;
-	Vector3 p1Add = p1Heading.normalized() * amt;
-	Vector3 p2Add = p2Heading.normalized() * amt;
-
-	point_1 = p1Heading + p1Add + midPoint;
-	point_2 = p2Heading + p2Add + midPoint;
+	elongate_points(point_1, point_2, amt);
 }
 
 Vector3 IKRay3D::get_intersects_plane(Vector3 ta, Vector3 tb, Vector3 tc) {
-	Vector3 uvw;
-	tta = ta;
-	ttb = tb;
-	ttc = tc;
-	tta -= point_1;
-	ttb -= point_1;
-	ttc -= point_1;
-	Vector3 result = plane_intersect_test(tta, ttb, ttc, &uvw);
-	return result + point_1;
+	return intersect_plane_points(point_1, point_2, ta, tb, tc);
 }
 
-int IKRay3D::intersects_sphere(Vector3 sphereCenter, real_t radius, Vector3 *S1, Vector3 *S2) {
-	Vector3 tp1 = point_1 - sphereCenter;
-	Vector3 tp2 = point_2 - sphereCenter;
-	int result = intersects_sphere(tp1, tp2, radius, S1, S2);
-	*S1 += sphereCenter;
-	*S2 += sphereCenter;
+void IKRay3D::elongate_points(Vector3 &r_point_1, Vector3 &r_point_2, real_t p_amount) {
+	Vector3 mid_point = (r_point_1 + r_point_2) * 0.5f;
+	Vector3 p1_heading = r_point_1 - mid_point;
+	Vector3 p2_heading = r_point_2 - mid_point;
+	r_point_1 = p1_heading + p1_heading.normalized() * p_amount + mid_point;
+	r_point_2 = p2_heading + p2_heading.normalized() * p_amount + mid_point;
+}
+
+Vector3 IKRay3D::intersect_plane_points(const Vector3 &p_point_1, const Vector3 &p_point_2, const Vector3 &p_vertex_a, const Vector3 &p_vertex_b, const Vector3 &p_vertex_c) {
+	// Same as plane_intersect_test() with the triangle taken relative to the ray's first point.
+	Vector3 ta = p_vertex_a - p_point_1;
+	Vector3 n = (p_vertex_b - p_vertex_a).cross(p_vertex_c - p_vertex_a).normalized();
+	Vector3 heading = p_point_2 - p_point_1;
+	real_t r = n.dot(ta) / n.dot(heading);
+	return heading * r + p_point_1;
+}
+
+int IKRay3D::intersect_sphere_points(const Vector3 &p_point_1, const Vector3 &p_point_2, const Vector3 &p_sphere_center, real_t p_radius, Vector3 *r_first_intersection, Vector3 *r_second_intersection) {
+	Vector3 rp1 = p_point_1 - p_sphere_center;
+	Vector3 e = (p_point_2 - p_point_1).normalized();
+	Vector3 h = -rp1;
+	real_t lf = e.dot(h);
+	real_t s = p_radius * p_radius - h.length_squared() + lf * lf;
+	int result = 0;
+	if (s >= 0.0f) {
+		s = Math::sqrt(s);
+		if (lf < s) {
+			if (lf + s >= 0) {
+				s = -s;
+				result = 1;
+			}
+		} else {
+			result = 2;
+		}
+		*r_first_intersection = e * (lf - s) + rp1;
+		*r_second_intersection = e * (lf + s) + rp1;
+	}
+	*r_first_intersection += p_sphere_center;
+	*r_second_intersection += p_sphere_center;
 	return result;
 }
 
+int IKRay3D::intersects_sphere(Vector3 sphereCenter, real_t radius, Vector3 *S1, Vector3 *S2) {
+	return intersect_sphere_points(point_1, point_2, sphereCenter, radius, S1, S2);
+}
+
 void IKRay3D::set_point_1(Vector3 in) {
 	point_1 = in;
 }
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  ik_solve_server_3d.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_solve_server_3d.h"
+
+#include "core/object/worker_thread_pool.h"
+#include "many_bone_ik_3d.h"
+#include "scene/main/scene_tree.h"
+
+IKSolveServer3D *IKSolveServer3D::singleton = nullptr;
+
+IKSolveServer3D *IKSolveServer3D::get_singleton() {
+	return singleton;
+}
+
+void IKSolveServer3D::register_modifier(ManyBoneIK3D *p_many_bone_ik) {
+	ERR_FAIL_NULL(p_many_bone_ik);
+	if (modifiers.has(p_many_bone_ik)) {
+		return;
+	}
+	modifiers.push_back(p_many_bone_ik);
+	SceneTree *tree = SceneTree::get_singleton();
+	if (tree && tree->get_instance_id() != frame_source) {
+		tree->connect(SNAME("process_frame"), callable_mp_static(&IKSolveServer3D::_advance_frame));
+		tree->connect(SNAME("physics_frame"), callable_mp_static(&IKSolveServer3D::_advance_frame));
+		frame_source = tree->get_instance_id();
+	}
+}
+
+void IKSolveServer3D::unregister_modifier(ManyBoneIK3D *p_many_bone_ik) {
+	modifiers.erase(p_many_bone_ik);
+}
+
+int32_t IKSolveServer3D::get_modifier_count() const {
+	return modifiers.size();
+}
+
+uint64_t IKSolveServer3D::get_frame() const {
+	return frame;
+}
+
+void IKSolveServer3D::_advance_frame() {
+	if (singleton) {
+		singleton->frame++;
+	}
+}
+
+void IKSolveServer3D::solve_pending() {
+	items.clear();
+	for (ManyBoneIK3D *many_bone_ik : modifiers) {
+		// Modifiers that still need a rebuild, or that already hold this frame's result, solve on their own turn.
+		if (!many_bone_ik->_begin_batched_solve()) {
+			continue;
+		}
+		uint32_t segment_count = many_bone_ik->segmented_skeletons.size();
+		for (uint32_t segment_i = 0; segment_i < segment_count; segment_i++) {
+			SolveItem item;
+			item.many_bone_ik = many_bone_ik;
+			item.segment_index = segment_i;
+			items.push_back(item);
+		}
+	}
+	if (items.is_empty()) {
+		return;
+	}
+	if (items.size() == 1) {
+		_solve_item(0, &items);
+		return;
+	}
+	WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &IKSolveServer3D::_solve_item, (const LocalVector<SolveItem> *)&items, items.size(), -1, true, SNAME("IKSolveServer3DSolve"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+}
+
+void IKSolveServer3D::_solve_item(uint32_t p_index, const LocalVector<SolveItem> *p_items) {
+	const SolveItem &item = (*p_items)[p_index];
+	item.many_bone_ik->_solve_root_segment(item.segment_index, &item.many_bone_ik->batch_parameters);
+}
+
+IKSolveServer3D::IKSolveServer3D() {
+	singleton = this;
+}
+
+IKSolveServer3D::~IKSolveServer3D() {
+	singleton = nullptr;
+}
@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*  ik_solve_server_3d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef IK_SOLVE_SERVER_3D_H
+#define IK_SOLVE_SERVER_3D_H
+
+#include "core/object/object_id.h"
+#include "core/templates/local_vector.h"
+
+class ManyBoneIK3D;
+
+// Solves every registered ManyBoneIK3D of a frame as one batch on the WorkerThreadPool.
+// The first batched modifier processed in a frame triggers the batch; the others only write their results back.
+// Results are tagged with the frame they were solved in, so one that is not consumed in that frame is solved again.
+class IKSolveServer3D {
+	static IKSolveServer3D *singleton;
+
+	struct SolveItem {
+		ManyBoneIK3D *many_bone_ik = nullptr;
+		uint32_t segment_index = 0;
+	};
+
+	LocalVector<ManyBoneIK3D *> modifiers;
+	LocalVector<SolveItem> items;
+	uint64_t frame = 1; // Advanced at the start of every process and physics frame of the scene tree.
+	ObjectID frame_source; // The scene tree advancing frame.
+
+	void _solve_item(uint32_t p_index, const LocalVector<SolveItem> *p_items);
+	static void _advance_frame();
+
+public:
+	static IKSolveServer3D *get_singleton();
+
+	void register_modifier(ManyBoneIK3D *p_many_bone_ik);
+	void unregister_modifier(ManyBoneIK3D *p_many_bone_ik);
+	int32_t get_modifier_count() const;
+	uint64_t get_frame() const;
+	void solve_pending();
+
+	IKSolveServer3D();
+	~IKSolveServer3D();
+};
+
+#endif // IK_SOLVE_SERVER_3D_H
@@ -33,10 +33,14 @@
 #include "core/math/math_defs.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/string/string_name.h"
 #include "ik_bone_3d.h"
 #include "ik_kusudama_3d.h"
 #include "ik_open_cone_3d.h"
+#include "ik_solve_server_3d.h"
+#include "main/performance.h"
 #include "scene/3d/marker_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/main/node.h"
@@ -89,7 +93,7 @@ void ManyBoneIK3D::set_pin_target_node_path(int32_t p_pin_index, const NodePath
 		pins.write[p_pin_index] = effector_template;
 	}
 	effector_template->set_target_node(p_target_node);
-	set_dirty();
+	_mark_dirty(DIRTY_EFFECTORS);
 }
 
 NodePath ManyBoneIK3D::get_pin_target_node_path(int32_t p_pin_index) {
@@ -98,6 +102,103 @@ NodePath ManyBoneIK3D::get_pin_target_node_path(int32_t p_pin_index) {
 	return effector_template->get_target_node();
 }
 
+void ManyBoneIK3D::_update_pin_effectors() {
+	pin_effectors.clear();
+	pin_effectors.resize(pins.size());
+	Skeleton3D *skeleton = get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	for (int32_t pin_i = 0; pin_i < pins.size(); pin_i++) {
+		const Ref<IKEffectorTemplate3D> &effector_template = pins[pin_i];
+		if (effector_template.is_null()) {
+			continue;
+		}
+		BoneId bone_id = skeleton->find_bone(effector_template->get_name());
+		if (bone_id == -1) {
+			continue;
+		}
+		for (const Ref<IKBoneSegment3D> &segmented_skeleton : segmented_skeletons) {
+			Ref<IKBone3D> ik_bone = segmented_skeleton.is_valid() ? segmented_skeleton->get_ik_bone(bone_id) : Ref<IKBone3D>();
+			if (ik_bone.is_valid() && ik_bone->is_pinned()) {
+				pin_effectors[pin_i] = ik_bone->get_pin();
+				break;
+			}
+		}
+	}
+}
+
+Ref<IKEffector3D> ManyBoneIK3D::_get_built_pin_effector(int32_t p_pin_index) const {
+	// Runtime pin state is written straight into the built effector; a pending rebuild picks it up from the template instead.
+	if ((dirty_flags & DIRTY_TOPOLOGY) || p_pin_index < 0 || uint32_t(p_pin_index) >= pin_effectors.size()) {
+		return Ref<IKEffector3D>();
+	}
+	return pin_effectors[p_pin_index];
+}
+
+void ManyBoneIK3D::set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	effector_template->set_target_transform(p_transform);
+	Ref<IKEffector3D> effector = _get_built_pin_effector(p_pin_index);
+	if (effector.is_valid()) {
+		effector->set_target_transform(p_transform);
+	}
+}
+
+Transform3D ManyBoneIK3D::get_pin_target_transform(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), Transform3D());
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), Transform3D());
+	return effector_template->get_target_transform();
+}
+
+void ManyBoneIK3D::clear_pin_target_transform(int32_t p_pin_index) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_valid()) {
+		effector_template->clear_target_transform();
+	}
+	Ref<IKEffector3D> effector = _get_built_pin_effector(p_pin_index);
+	if (effector.is_valid()) {
+		effector->clear_target_transform();
+		effector->clear_target_node_cache();
+	}
+}
+
+void ManyBoneIK3D::set_pin_target_transforms(const Transform3D *p_transforms, int32_t p_count) {
+	ERR_FAIL_COND(p_count > 0 && !p_transforms);
+	int32_t count = MIN(p_count, pins.size());
+	for (int32_t pin_i = 0; pin_i < count; pin_i++) {
+		set_pin_target_transform(pin_i, p_transforms[pin_i]);
+	}
+}
+
+void ManyBoneIK3D::_set_pin_target_transforms_bind(const PackedFloat32Array &p_transforms) {
+	// Twelve floats per pin in the row-major 3x4 layout MultiMesh buffers use: each basis row followed by one origin component.
+	ERR_FAIL_COND_MSG(p_transforms.size() % 12 != 0, "Pin target transforms must hold 12 floats per pin.");
+	const float *data = p_transforms.ptr();
+	int32_t count = MIN(p_transforms.size() / 12, pins.size());
+	for (int32_t pin_i = 0; pin_i < count; pin_i++) {
+		const float *row = data + pin_i * 12;
+		Transform3D transform;
+		transform.basis.rows[0] = Vector3(row[0], row[1], row[2]);
+		transform.basis.rows[1] = Vector3(row[4], row[5], row[6]);
+		transform.basis.rows[2] = Vector3(row[8], row[9], row[10]);
+		transform.origin = Vector3(row[3], row[7], row[11]);
+		set_pin_target_transform(pin_i, transform);
+	}
+}
+
+void ManyBoneIK3D::_set_pin_target_transform_array_bind(const TypedArray<Transform3D> &p_transforms) {
+	int32_t count = MIN(p_transforms.size(), pins.size());
+	for (int32_t pin_i = 0; pin_i < count; pin_i++) {
+		set_pin_target_transform(pin_i, p_transforms[pin_i]);
+	}
+}
+
 Vector<Ref<IKEffectorTemplate3D>> ManyBoneIK3D::_get_bone_effectors() const {
 	return pins;
 }
@@ -111,19 +212,43 @@ void ManyBoneIK3D::_remove_pin(int32_t p_index) {
 }
 
 void ManyBoneIK3D::_update_ik_bones_transform() {
+	Skeleton3D *skeleton = get_skeleton();
+	if (!skeleton) {
+		return;
+	}
+	const Transform3D skeleton_inverse = skeleton->get_global_transform().affine_inverse();
 	for (int32_t bone_i = bone_list.size(); bone_i-- > 0;) {
 		Ref<IKBone3D> bone = bone_list[bone_i];
 		if (bone.is_null()) {
 			continue;
 		}
-		bone->set_initial_pose(get_skeleton());
+		bone->set_initial_pose(skeleton);
 		if (bone->is_pinned()) {
-			bone->get_pin()->update_target_global_transform(get_skeleton(), this);
+			bone->get_pin()->update_target_global_transform(skeleton_inverse, this);
+		}
+	}
+}
+
+void ManyBoneIK3D::_clear_target_node_caches() {
+	for (const Ref<IKBone3D> &bone : bone_list) {
+		if (bone.is_valid() && bone->is_pinned()) {
+			bone->get_pin()->clear_target_node_cache();
+		}
+	}
+}
+
+void ManyBoneIK3D::_on_node_renamed(Node *p_node) {
+	for (const Ref<IKEffector3D> &effector : pin_effectors) {
+		if (effector.is_valid()) {
+			effector->notify_node_renamed(p_node);
 		}
 	}
 }
 
 void ManyBoneIK3D::_update_skeleton_bones_transform() {
+#ifdef DEBUG_ENABLED
+	uint64_t write_back_begin = OS::get_singleton()->get_ticks_usec();
+#endif
 	for (int32_t bone_i = bone_list.size(); bone_i-- > 0;) {
 		Ref<IKBone3D> bone = bone_list[bone_i];
 		if (bone.is_null()) {
@@ -134,6 +259,9 @@ void ManyBoneIK3D::_update_skeleton_bones_transform() {
 		}
 		bone->set_skeleton_bone_pose(get_skeleton());
 	}
+#ifdef DEBUG_ENABLED
+	pending_stats.write_back_usec += OS::get_singleton()->get_ticks_usec() - write_back_begin;
+#endif
 	update_gizmos();
 }
 
@@ -175,10 +303,18 @@ void ManyBoneIK3D::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(effector_name);
 		p_list->push_back(
 				PropertyInfo(Variant::NODE_PATH, "pins/" + itos(pin_i) + "/target_node", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "Node3D", pin_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::BOOL, "pins/" + itos(pin_i) + "/target_static", PROPERTY_HINT_NONE, "", pin_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::FLOAT, "pins/" + itos(pin_i) + "/motion_propagation_factor", PROPERTY_HINT_RANGE, "0,1,0.1,or_greater", pin_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::FLOAT, "pins/" + itos(pin_i) + "/weight", PROPERTY_HINT_RANGE, "0,1,0.1,or_greater", pin_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::FLOAT, "pins/" + itos(pin_i) + "/blend_weight", PROPERTY_HINT_RANGE, "0,1,0.01,or_greater", pin_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::OBJECT, "pins/" + itos(pin_i) + "/weight_falloff_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve", pin_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::FLOAT, "pins/" + itos(pin_i) + "/weight_falloff_distance", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater,suffix:m", pin_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::VECTOR3, "pins/" + itos(pin_i) + "/direction_priorities", PROPERTY_HINT_RANGE, "0,1,0.1,or_greater", pin_usage));
 	}
@@ -215,6 +351,8 @@ void ManyBoneIK3D::_get_property_list(List<PropertyInfo> *p_list) const {
 				PropertyInfo(Variant::FLOAT, "constraints/" + itos(constraint_i) + "/twist_start", PROPERTY_HINT_RANGE, "-359.9,359.9,0.1,radians,exp", constraint_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::FLOAT, "constraints/" + itos(constraint_i) + "/twist_end", PROPERTY_HINT_RANGE, "-359.9,359.9,0.1,radians,exp", constraint_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::FLOAT, "constraints/" + itos(constraint_i) + "/resistance", PROPERTY_HINT_RANGE, "0,1,0.01", constraint_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::INT, "constraints/" + itos(constraint_i) + "/kusudama_open_cone_count", PROPERTY_HINT_RANGE, "0,10,1", constraint_usage | PROPERTY_USAGE_ARRAY | PROPERTY_USAGE_READ_ONLY,
 						"Limit Cones,constraints/" + itos(constraint_i) + "/kusudama_open_cone/"));
@@ -266,6 +404,18 @@ bool ManyBoneIK3D::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "direction_priorities") {
 			r_ret = get_pin_direction_priorities(index);
 			return true;
+		} else if (what == "target_static") {
+			r_ret = is_pin_target_static(index);
+			return true;
+		} else if (what == "blend_weight") {
+			r_ret = get_pin_blend_weight(index);
+			return true;
+		} else if (what == "weight_falloff_curve") {
+			r_ret = get_pin_weight_falloff_curve(index);
+			return true;
+		} else if (what == "weight_falloff_distance") {
+			r_ret = get_pin_weight_falloff_distance(index);
+			return true;
 		}
 	} else if (name.begins_with("constraints/")) {
 		int index = name.get_slicec('/', 1).to_int();
@@ -282,6 +432,9 @@ bool ManyBoneIK3D::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "twist_end") {
 			r_ret = get_joint_twist(index).y;
 			return true;
+		} else if (what == "resistance") {
+			r_ret = get_kusudama_resistance(index);
+			return true;
 		} else if (what == "kusudama_open_cone_count") {
 			r_ret = get_kusudama_open_cone_count(index);
 			return true;
@@ -339,6 +492,18 @@ bool ManyBoneIK3D::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (what == "direction_priorities") {
 			set_pin_direction_priorities(index, p_value);
 			return true;
+		} else if (what == "target_static") {
+			set_pin_target_static(index, p_value);
+			return true;
+		} else if (what == "blend_weight") {
+			set_pin_blend_weight(index, p_value);
+			return true;
+		} else if (what == "weight_falloff_curve") {
+			set_pin_weight_falloff_curve(index, p_value);
+			return true;
+		} else if (what == "weight_falloff_distance") {
+			set_pin_weight_falloff_distance(index, p_value);
+			return true;
 		}
 	} else if (name.begins_with("constraints/")) {
 		int index = name.get_slicec('/', 1).to_int();
@@ -358,6 +523,9 @@ bool ManyBoneIK3D::_set(const StringName &p_name, const Variant &p_value) {
 			Vector2 twist_range = get_joint_twist(index);
 			set_joint_twist(index, Vector2(twist_range.x, p_value));
 			return true;
+		} else if (what == "resistance") {
+			set_kusudama_resistance(index, p_value);
+			return true;
 		} else if (what == "kusudama_open_cone_count") {
 			set_kusudama_open_cone_count(index, p_value);
 			return true;
@@ -407,6 +575,8 @@ void ManyBoneIK3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_kusudama_open_cone_count", "index"), &ManyBoneIK3D::get_kusudama_open_cone_count);
 	ClassDB::bind_method(D_METHOD("set_joint_twist", "index", "limit"), &ManyBoneIK3D::set_joint_twist);
 	ClassDB::bind_method(D_METHOD("get_joint_twist", "index"), &ManyBoneIK3D::get_joint_twist);
+	ClassDB::bind_method(D_METHOD("set_kusudama_resistance", "index", "resistance"), &ManyBoneIK3D::set_kusudama_resistance);
+	ClassDB::bind_method(D_METHOD("get_kusudama_resistance", "index"), &ManyBoneIK3D::get_kusudama_resistance);
 	ClassDB::bind_method(D_METHOD("set_pin_motion_propagation_factor", "index", "falloff"), &ManyBoneIK3D::set_pin_motion_propagation_factor);
 	ClassDB::bind_method(D_METHOD("get_pin_motion_propagation_factor", "index"), &ManyBoneIK3D::get_pin_motion_propagation_factor);
 	ClassDB::bind_method(D_METHOD("get_pin_count"), &ManyBoneIK3D::get_pin_count);
@@ -420,6 +590,19 @@ void ManyBoneIK3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_pin_weight", "index", "weight"), &ManyBoneIK3D::set_pin_weight);
 	ClassDB::bind_method(D_METHOD("get_pin_weight", "index"), &ManyBoneIK3D::get_pin_weight);
 	ClassDB::bind_method(D_METHOD("get_pin_enabled", "index"), &ManyBoneIK3D::get_pin_enabled);
+	ClassDB::bind_method(D_METHOD("set_pin_target_transform", "index", "transform"), &ManyBoneIK3D::set_pin_target_transform);
+	ClassDB::bind_method(D_METHOD("get_pin_target_transform", "index"), &ManyBoneIK3D::get_pin_target_transform);
+	ClassDB::bind_method(D_METHOD("clear_pin_target_transform", "index"), &ManyBoneIK3D::clear_pin_target_transform);
+	ClassDB::bind_method(D_METHOD("set_pin_target_static", "index", "target_static"), &ManyBoneIK3D::set_pin_target_static);
+	ClassDB::bind_method(D_METHOD("set_pin_blend_weight", "index", "blend_weight"), &ManyBoneIK3D::set_pin_blend_weight);
+	ClassDB::bind_method(D_METHOD("get_pin_blend_weight", "index"), &ManyBoneIK3D::get_pin_blend_weight);
+	ClassDB::bind_method(D_METHOD("set_pin_weight_falloff_curve", "index", "curve"), &ManyBoneIK3D::set_pin_weight_falloff_curve);
+	ClassDB::bind_method(D_METHOD("get_pin_weight_falloff_curve", "index"), &ManyBoneIK3D::get_pin_weight_falloff_curve);
+	ClassDB::bind_method(D_METHOD("set_pin_weight_falloff_distance", "index", "distance"), &ManyBoneIK3D::set_pin_weight_falloff_distance);
+	ClassDB::bind_method(D_METHOD("get_pin_weight_falloff_distance", "index"), &ManyBoneIK3D::get_pin_weight_falloff_distance);
+	ClassDB::bind_method(D_METHOD("is_pin_target_static", "index"), &ManyBoneIK3D::is_pin_target_static);
+	ClassDB::bind_method(D_METHOD("set_pin_target_transforms", "transforms"), &ManyBoneIK3D::_set_pin_target_transforms_bind);
+	ClassDB::bind_method(D_METHOD("set_pin_target_transform_array", "transforms"), &ManyBoneIK3D::_set_pin_target_transform_array_bind);
 	ClassDB::bind_method(D_METHOD("get_constraint_name", "index"), &ManyBoneIK3D::get_constraint_name);
 	ClassDB::bind_method(D_METHOD("get_iterations_per_frame"), &ManyBoneIK3D::get_iterations_per_frame);
 	ClassDB::bind_method(D_METHOD("set_iterations_per_frame", "count"), &ManyBoneIK3D::set_iterations_per_frame);
@@ -437,18 +620,58 @@ void ManyBoneIK3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_stabilization_passes", "passes"), &ManyBoneIK3D::set_stabilization_passes);
 	ClassDB::bind_method(D_METHOD("get_stabilization_passes"), &ManyBoneIK3D::get_stabilization_passes);
 	ClassDB::bind_method(D_METHOD("set_effector_bone_name", "index", "name"), &ManyBoneIK3D::set_pin_bone_name);
+	ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &ManyBoneIK3D::set_thread_count);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &ManyBoneIK3D::get_thread_count);
+	ClassDB::bind_method(D_METHOD("set_parallel_child_segments", "enabled"), &ManyBoneIK3D::set_parallel_child_segments);
+	ClassDB::bind_method(D_METHOD("is_parallel_child_segments"), &ManyBoneIK3D::is_parallel_child_segments);
+	ClassDB::bind_method(D_METHOD("set_convergence_enabled", "enabled"), &ManyBoneIK3D::set_convergence_enabled);
+	ClassDB::bind_method(D_METHOD("is_convergence_enabled"), &ManyBoneIK3D::is_convergence_enabled);
+	ClassDB::bind_method(D_METHOD("set_convergence_epsilon", "epsilon"), &ManyBoneIK3D::set_convergence_epsilon);
+	ClassDB::bind_method(D_METHOD("get_convergence_epsilon"), &ManyBoneIK3D::get_convergence_epsilon);
+	ClassDB::bind_method(D_METHOD("set_convergence_threshold", "threshold"), &ManyBoneIK3D::set_convergence_threshold);
+	ClassDB::bind_method(D_METHOD("get_convergence_threshold"), &ManyBoneIK3D::get_convergence_threshold);
+	ClassDB::bind_method(D_METHOD("set_solver_precision", "precision"), &ManyBoneIK3D::set_solver_precision);
+	ClassDB::bind_method(D_METHOD("get_solver_precision"), &ManyBoneIK3D::get_solver_precision);
+	ClassDB::bind_method(D_METHOD("get_last_iteration_count"), &ManyBoneIK3D::get_last_iteration_count);
+	ClassDB::bind_method(D_METHOD("get_last_solve_error"), &ManyBoneIK3D::get_last_solve_error);
+	ClassDB::bind_method(D_METHOD("get_solver_stats"), &ManyBoneIK3D::get_solver_stats);
+	ClassDB::bind_method(D_METHOD("set_batched_solve", "enabled"), &ManyBoneIK3D::set_batched_solve);
+	ClassDB::bind_method(D_METHOD("is_batched_solve"), &ManyBoneIK3D::is_batched_solve);
+	ClassDB::bind_method(D_METHOD("set_constraint_bounds_grid_resolution", "resolution"), &ManyBoneIK3D::set_constraint_bounds_grid_resolution);
+	ClassDB::bind_method(D_METHOD("get_constraint_bounds_grid_resolution"), &ManyBoneIK3D::get_constraint_bounds_grid_resolution);
+	ClassDB::bind_method(D_METHOD("get_constraint_bounds_grid_memory_usage"), &ManyBoneIK3D::get_constraint_bounds_grid_memory_usage);
+	ClassDB::bind_method(D_METHOD("is_pose_within_constraints", "bone_poses", "tolerance"), &ManyBoneIK3D::is_pose_within_constraints, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("is_skeleton_pose_within_constraints", "skeleton", "tolerance"), &ManyBoneIK3D::is_skeleton_pose_within_constraints, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("get_pose_constraint_violations", "bone_poses"), &ManyBoneIK3D::get_pose_constraint_violations);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "iterations_per_frame", PROPERTY_HINT_RANGE, "1,150,1,or_greater"), "set_iterations_per_frame", "get_iterations_per_frame");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "default_damp", PROPERTY_HINT_RANGE, "0.01,180.0,0.1,radians,exp", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), "set_default_damp", "get_default_damp");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "constraint_mode"), "set_constraint_mode", "get_constraint_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "ui_selected_bone", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_ui_selected_bone", "get_ui_selected_bone");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "stabilization_passes"), "set_stabilization_passes", "get_stabilization_passes");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "convergence_enabled"), "set_convergence_enabled", "is_convergence_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "convergence_epsilon", PROPERTY_HINT_RANGE, "0,0.01,0.0000001,or_greater,exp"), "set_convergence_epsilon", "get_convergence_epsilon");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "convergence_threshold", PROPERTY_HINT_RANGE, "0,0.01,0.0000001,or_greater,exp"), "set_convergence_threshold", "get_convergence_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batched_solve"), "set_batched_solve", "is_batched_solve");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_child_segments"), "set_parallel_child_segments", "is_parallel_child_segments");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "thread_count", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_thread_count", "get_thread_count");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "constraint_bounds_grid_resolution", PROPERTY_HINT_RANGE, "0,1024,2"), "set_constraint_bounds_grid_resolution", "get_constraint_bounds_grid_resolution");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "solver_precision", PROPERTY_HINT_ENUM, "Double,Float"), "set_solver_precision", "get_solver_precision");
+
+	BIND_ENUM_CONSTANT(SOLVER_PRECISION_DOUBLE);
+	BIND_ENUM_CONSTANT(SOLVER_PRECISION_FLOAT);
 }
 
 ManyBoneIK3D::ManyBoneIK3D() {
 }
 
 ManyBoneIK3D::~ManyBoneIK3D() {
+	if (IKSolveServer3D::get_singleton()) {
+		IKSolveServer3D::get_singleton()->unregister_modifier(this);
+	}
+#ifdef DEBUG_ENABLED
+	_remove_monitored_instance(this);
+#endif
 }
 
 float ManyBoneIK3D::get_pin_motion_propagation_factor(int32_t p_effector_index) const {
@@ -462,7 +685,7 @@ void ManyBoneIK3D::set_pin_motion_propagation_factor(int32_t p_effector_index, c
 	Ref<IKEffectorTemplate3D> effector_template = pins[p_effector_index];
 	ERR_FAIL_COND(effector_template.is_null());
 	effector_template->set_motion_propagation_factor(p_motion_propagation_factor);
-	set_dirty();
+	_mark_dirty(DIRTY_EFFECTORS);
 }
 
 void ManyBoneIK3D::_set_constraint_count(int32_t p_count) {
@@ -470,6 +693,7 @@ void ManyBoneIK3D::_set_constraint_count(int32_t p_count) {
 	constraint_count = p_count;
 	constraint_names.resize(p_count);
 	joint_twist.resize(p_count);
+	kusudama_resistance.resize(p_count);
 	kusudama_open_cone_count.resize(p_count);
 	kusudama_open_cones.resize(p_count);
 	for (int32_t constraint_i = p_count; constraint_i-- > old_count;) {
@@ -478,6 +702,7 @@ void ManyBoneIK3D::_set_constraint_count(int32_t p_count) {
 		kusudama_open_cones.write[constraint_i].resize(1);
 		kusudama_open_cones.write[constraint_i].write[0] = Vector4(0, 1, 0, 0.01745f);
 		joint_twist.write[constraint_i] = Vector2(0, 0.01745f);
+		kusudama_resistance.write[constraint_i] = 0.0f;
 	}
 	set_dirty();
 	notify_property_list_changed();
@@ -500,7 +725,18 @@ Vector2 ManyBoneIK3D::get_joint_twist(int32_t p_index) const {
 void ManyBoneIK3D::set_joint_twist(int32_t p_index, Vector2 p_to) {
 	ERR_FAIL_INDEX(p_index, constraint_count);
 	joint_twist.write[p_index] = p_to;
-	set_dirty();
+	_mark_constraint_dirty(p_index);
+}
+
+float ManyBoneIK3D::get_kusudama_resistance(int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_index, kusudama_resistance.size(), 0.0f);
+	return kusudama_resistance[p_index];
+}
+
+void ManyBoneIK3D::set_kusudama_resistance(int32_t p_index, float p_resistance) {
+	ERR_FAIL_INDEX(p_index, kusudama_resistance.size());
+	kusudama_resistance.write[p_index] = CLAMP(p_resistance, 0.0f, 1.0f);
+	_mark_constraint_dirty(p_index);
 }
 
 int32_t ManyBoneIK3D::find_pin_id(StringName p_bone_name) {
@@ -527,7 +763,7 @@ void ManyBoneIK3D::set_kusudama_open_cone(int32_t p_constraint_index, int32_t p_
 	cone.w = p_radius;
 	cones.write[p_index] = cone;
 	kusudama_open_cones.write[p_constraint_index] = cones;
-	set_dirty();
+	_mark_constraint_dirty(p_constraint_index);
 }
 
 float ManyBoneIK3D::get_kusudama_open_cone_radius(int32_t p_constraint_index, int32_t p_index) const {
@@ -558,7 +794,7 @@ void ManyBoneIK3D::set_kusudama_open_cone_count(int32_t p_constraint_index, int3
 		cone.z = forward_axis.z;
 		cone.w = Math::deg_to_rad(0.0f);
 	}
-	set_dirty();
+	_mark_constraint_dirty(p_constraint_index);
 	notify_property_list_changed();
 }
 
@@ -568,7 +804,7 @@ real_t ManyBoneIK3D::get_default_damp() const {
 
 void ManyBoneIK3D::set_default_damp(float p_default_damp) {
 	default_damp = p_default_damp;
-	set_dirty();
+	_mark_dirty(DIRTY_DAMPING);
 }
 
 StringName ManyBoneIK3D::get_pin_bone_name(int32_t p_effector_index) const {
@@ -584,7 +820,7 @@ void ManyBoneIK3D::set_kusudama_open_cone_radius(int32_t p_effector_index, int32
 	ERR_FAIL_INDEX(p_index, kusudama_open_cones[p_effector_index].size());
 	Vector4 &cone = kusudama_open_cones.write[p_effector_index].write[p_index];
 	cone.w = p_radius;
-	set_dirty();
+	_mark_constraint_dirty(p_effector_index);
 }
 
 void ManyBoneIK3D::set_kusudama_open_cone_center(int32_t p_effector_index, int32_t p_index, Vector3 p_center) {
@@ -600,7 +836,7 @@ void ManyBoneIK3D::set_kusudama_open_cone_center(int32_t p_effector_index, int32
 		cone.y = p_center.y;
 		cone.z = p_center.z;
 	}
-	set_dirty();
+	_mark_constraint_dirty(p_effector_index);
 }
 
 Vector3 ManyBoneIK3D::get_kusudama_open_cone_center(int32_t p_constraint_index, int32_t p_index) const {
@@ -636,6 +872,7 @@ float ManyBoneIK3D::get_iterations_per_frame() const {
 
 void ManyBoneIK3D::set_iterations_per_frame(const float &p_iterations_per_frame) {
 	iterations_per_frame = p_iterations_per_frame;
+	_mark_dirty(DIRTY_DAMPING);
 }
 
 void ManyBoneIK3D::set_pin_node_path(int32_t p_effector_index, NodePath p_node_path) {
@@ -661,9 +898,20 @@ void ManyBoneIK3D::_process_modification() {
 	if (!segmented_skeletons.size()) {
 		set_dirty();
 	}
-	if (is_dirty) {
-		is_dirty = false;
+	if (dirty_flags & DIRTY_TOPOLOGY) {
 		_bone_list_changed();
+	} else if (dirty_flags != DIRTY_NONE) {
+		if (dirty_flags & DIRTY_EFFECTORS) {
+			_update_dirty_effectors();
+		}
+		if (dirty_flags & DIRTY_CONSTRAINTS) {
+			_update_dirty_constraints();
+		}
+		if (dirty_flags & DIRTY_DAMPING) {
+			_update_dirty_damping();
+		}
+		dirty_flags = DIRTY_NONE;
+		dirty_constraints.clear();
 	}
 	if (bone_list.size()) {
 		Ref<IKNode3D> root_ik_bone = bone_list.write[0]->get_ik_transform();
@@ -681,15 +929,109 @@ void ManyBoneIK3D::_process_modification() {
 	if (!is_visible()) {
 		return;
 	}
-	for (int32_t i = 0; i < get_iterations_per_frame(); i++) {
-		for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
-			if (segmented_skeleton.is_null()) {
-				continue;
-			}
-			segmented_skeleton->segment_solver(bone_damp, get_default_damp(), get_constraint_mode(), i, get_iterations_per_frame());
+	if (batched_solve && IKSolveServer3D::get_singleton()) {
+		if (!_has_current_batch_result()) {
+			_drop_batch_result();
+			IKSolveServer3D::get_singleton()->solve_pending();
+		}
+		if (_has_current_batch_result()) {
+			batch_solved = false;
+			_update_skeleton_bones_transform();
+#ifdef DEBUG_ENABLED
+			_finish_solver_stats();
+#endif
+			return;
+		}
+	}
+	SolveParameters parameters = _get_solve_parameters();
+	// Root segments share no bones, effectors or transforms, so each one can run its whole iteration loop on its own.
+	uint32_t segment_count = segmented_skeletons.size();
+	if (thread_count > 1 && segment_count > 1) {
+		WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &ManyBoneIK3D::_solve_root_segment, &parameters, segment_count, MIN((uint32_t)thread_count, segment_count), true, SNAME("ManyBoneIK3DSolveRootSegments"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	} else {
+		for (uint32_t segment_i = 0; segment_i < segment_count; segment_i++) {
+			_solve_root_segment(segment_i, &parameters);
 		}
 	}
 	_update_skeleton_bones_transform();
+#ifdef DEBUG_ENABLED
+	_finish_solver_stats();
+#endif
+}
+
+ManyBoneIK3D::SolveParameters ManyBoneIK3D::_get_solve_parameters() const {
+	SolveParameters parameters;
+	parameters.iterations = get_iterations_per_frame();
+	parameters.default_damp = get_default_damp();
+	parameters.constraint_mode = get_constraint_mode();
+	parameters.parallel_child_segments = parallel_child_segments;
+	parameters.convergence_enabled = convergence_enabled;
+	parameters.convergence_epsilon = convergence_epsilon;
+	parameters.convergence_threshold = convergence_threshold;
+	parameters.solver_precision = solver_precision;
+	return parameters;
+}
+
+void ManyBoneIK3D::_drop_batch_result() {
+	if (!batch_solved) {
+		return;
+	}
+	// The skeleton skipped the update the result was solved for, so the next solve starts over from its current pose.
+	batch_solved = false;
+	_update_ik_bones_transform();
+}
+
+bool ManyBoneIK3D::_has_current_batch_result() const {
+	return batch_solved && batch_frame == IKSolveServer3D::get_singleton()->get_frame();
+}
+
+bool ManyBoneIK3D::_begin_batched_solve() {
+	// The solver inputs were seeded when the previous modification finished, so solving
+	// ahead of this skeleton's own update gives the same result as solving during it.
+	if (_has_current_batch_result() || dirty_flags != DIRTY_NONE || segmented_skeletons.is_empty() || !get_skeleton() || !is_enabled() || !is_visible()) {
+		return false;
+	}
+	_drop_batch_result();
+	batch_parameters = _get_solve_parameters();
+	batch_solved = true;
+	batch_frame = IKSolveServer3D::get_singleton()->get_frame();
+	return true;
+}
+
+void ManyBoneIK3D::_solve_root_segment(uint32_t p_index, const SolveParameters *p_parameters) {
+	const Ref<IKBoneSegment3D> &segmented_skeleton = segmented_skeletons[p_index];
+	if (segmented_skeleton.is_null()) {
+		return;
+	}
+#ifdef DEBUG_ENABLED
+	segmented_skeleton->reset_solver_stats();
+	uint64_t solve_begin = OS::get_singleton()->get_ticks_usec();
+#endif
+	segmented_skeleton->set_solver_precision(p_parameters->solver_precision == SOLVER_PRECISION_FLOAT ? QCPSolver::SCALAR_PRECISION_FLOAT : QCPSolver::SCALAR_PRECISION_DOUBLE);
+	if (!p_parameters->convergence_enabled) {
+		for (int32_t i = 0; i < p_parameters->iterations; i++) {
+			segmented_skeleton->segment_solver(bone_damp, p_parameters->default_damp, p_parameters->constraint_mode, i, p_parameters->iterations, p_parameters->parallel_child_segments);
+		}
+		segmented_skeleton->set_last_solve_result(p_parameters->iterations, -1.0);
+	} else {
+		double previous_error = INFINITY;
+		double error = INFINITY;
+		int32_t iteration_count = 0;
+		while (iteration_count < p_parameters->iterations) {
+			segmented_skeleton->segment_solver(bone_damp, p_parameters->default_damp, p_parameters->constraint_mode, iteration_count, p_parameters->iterations, p_parameters->parallel_child_segments);
+			iteration_count++;
+			error = segmented_skeleton->compute_heading_error();
+			if (error <= p_parameters->convergence_threshold || previous_error - error < p_parameters->convergence_epsilon) {
+				break;
+			}
+			previous_error = error;
+		}
+		segmented_skeleton->set_last_solve_result(iteration_count, error);
+	}
+#ifdef DEBUG_ENABLED
+	segmented_skeleton->get_solver_stats().solve_usec += OS::get_singleton()->get_ticks_usec() - solve_begin;
+#endif
 }
 
 real_t ManyBoneIK3D::get_pin_weight(int32_t p_pin_index) const {
@@ -706,7 +1048,88 @@ void ManyBoneIK3D::set_pin_weight(int32_t p_pin_index, const real_t &p_weight) {
 		pins.write[p_pin_index] = effector_template;
 	}
 	effector_template->set_weight(p_weight);
-	set_dirty();
+	_mark_dirty(DIRTY_EFFECTORS);
+}
+
+real_t ManyBoneIK3D::get_pin_blend_weight(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), 0.0);
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), 0.0);
+	return effector_template->get_blend_weight();
+}
+
+void ManyBoneIK3D::set_pin_blend_weight(int32_t p_pin_index, real_t p_blend_weight) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	effector_template->set_blend_weight(p_blend_weight);
+	Ref<IKEffector3D> effector = _get_built_pin_effector(p_pin_index);
+	if (effector.is_valid()) {
+		effector->set_blend_weight(p_blend_weight);
+	}
+}
+
+Ref<Curve> ManyBoneIK3D::get_pin_weight_falloff_curve(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), Ref<Curve>());
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), Ref<Curve>());
+	return effector_template->get_weight_falloff_curve();
+}
+
+void ManyBoneIK3D::set_pin_weight_falloff_curve(int32_t p_pin_index, const Ref<Curve> &p_curve) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	effector_template->set_weight_falloff_curve(p_curve);
+	Ref<IKEffector3D> effector = _get_built_pin_effector(p_pin_index);
+	if (effector.is_valid()) {
+		effector->set_weight_falloff_curve(p_curve);
+	}
+}
+
+real_t ManyBoneIK3D::get_pin_weight_falloff_distance(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), 0.0);
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), 0.0);
+	return effector_template->get_weight_falloff_distance();
+}
+
+void ManyBoneIK3D::set_pin_weight_falloff_distance(int32_t p_pin_index, real_t p_distance) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	effector_template->set_weight_falloff_distance(p_distance);
+	Ref<IKEffector3D> effector = _get_built_pin_effector(p_pin_index);
+	if (effector.is_valid()) {
+		effector->set_weight_falloff_distance(p_distance);
+	}
+}
+
+bool ManyBoneIK3D::is_pin_target_static(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), false);
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), false);
+	return effector_template->is_target_static();
+}
+
+void ManyBoneIK3D::set_pin_target_static(int32_t p_pin_index, bool p_static) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	effector_template->set_target_static(p_static);
+	_mark_dirty(DIRTY_EFFECTORS);
 }
 
 Vector3 ManyBoneIK3D::get_pin_direction_priorities(int32_t p_pin_index) const {
@@ -723,11 +1146,132 @@ void ManyBoneIK3D::set_pin_direction_priorities(int32_t p_pin_index, const Vecto
 		pins.write[p_pin_index] = effector_template;
 	}
 	effector_template->set_direction_priorities(p_priority_direction);
-	set_dirty();
+	_mark_dirty(DIRTY_EFFECTORS);
 }
 
 void ManyBoneIK3D::set_dirty() {
-	is_dirty = true;
+	dirty_flags |= DIRTY_TOPOLOGY;
+}
+
+void ManyBoneIK3D::_mark_dirty(DirtyFlags p_flag) {
+	dirty_flags |= p_flag;
+}
+
+void ManyBoneIK3D::_mark_constraint_dirty(int32_t p_index) {
+	dirty_constraints.insert(p_index);
+	dirty_flags |= DIRTY_CONSTRAINTS;
+}
+
+void ManyBoneIK3D::_update_dirty_effectors() {
+	Skeleton3D *skeleton = get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	for (const Ref<IKEffectorTemplate3D> &effector_template : pins) {
+		if (effector_template.is_null()) {
+			continue;
+		}
+		BoneId bone_id = skeleton->find_bone(effector_template->get_name());
+		if (bone_id == -1) {
+			continue;
+		}
+		for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+			if (segmented_skeleton.is_null()) {
+				continue;
+			}
+			Ref<IKBone3D> ik_bone = segmented_skeleton->get_ik_bone(bone_id);
+			if (ik_bone.is_null() || !ik_bone->is_pinned()) {
+				continue;
+			}
+			Ref<IKEffector3D> effector = ik_bone->get_pin();
+			effector->set_target_node(skeleton, effector_template->get_target_node());
+			effector->set_target_static(effector_template->is_target_static());
+			if (effector_template->is_target_transform_fed()) {
+				effector->set_target_transform(effector_template->get_target_transform());
+			} else {
+				effector->clear_target_transform();
+			}
+			effector->set_motion_propagation_factor(effector_template->get_motion_propagation_factor());
+			effector->set_weight(effector_template->get_weight());
+			effector->set_blend_weight(effector_template->get_blend_weight());
+			effector->set_weight_falloff_curve(effector_template->get_weight_falloff_curve());
+			effector->set_weight_falloff_distance(effector_template->get_weight_falloff_distance());
+			effector->set_direction_priorities(effector_template->get_direction_priorities());
+			break;
+		}
+	}
+	// Weights, priorities and propagation only change the heading layout, never which bones are pinned.
+	for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_null()) {
+			continue;
+		}
+		Vector<Vector<double>> weight_array;
+		segmented_skeleton->update_pinned_list(weight_array);
+		IKBoneSegment3D::recursive_create_headings_arrays_for(segmented_skeleton);
+	}
+}
+
+void ManyBoneIK3D::_update_dirty_constraints() {
+	Skeleton3D *skeleton = get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	for (const int32_t &constraint_i : dirty_constraints) {
+		if (constraint_i < 0 || constraint_i >= constraint_count) {
+			continue;
+		}
+		BoneId bone_id = skeleton->find_bone(constraint_names[constraint_i]);
+		if (bone_id == -1) {
+			continue;
+		}
+		for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+			if (segmented_skeleton.is_null()) {
+				continue;
+			}
+			Ref<IKBone3D> ik_bone = segmented_skeleton->get_ik_bone(bone_id);
+			if (ik_bone.is_null()) {
+				continue;
+			}
+			// _update_constraint() rotates the twist axes relative to where they are, so start from the rest frame again.
+			ik_bone->get_constraint_twist_transform()->set_transform(Transform3D());
+			_build_constraint(constraint_i, ik_bone);
+			break;
+		}
+	}
+}
+
+void ManyBoneIK3D::_update_dirty_damping() {
+	for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_null()) {
+			continue;
+		}
+		segmented_skeleton->set_stabilizing_pass_count(stabilize_passes);
+		segmented_skeleton->update_dampening(get_default_damp(), get_iterations_per_frame());
+	}
+}
+
+void ManyBoneIK3D::_build_constraint(int32_t p_constraint_index, Ref<IKBone3D> p_ik_bone) {
+	Ref<IKKusudama3D> constraint;
+	constraint.instantiate();
+	constraint->enable_orientational_limits();
+	constraint->set_bounds_grid_resolution(constraint_bounds_grid_resolution);
+
+	int32_t cone_count = kusudama_open_cone_count[p_constraint_index];
+	const Vector<Vector4> &cones = kusudama_open_cones[p_constraint_index];
+	for (int32_t cone_i = 0; cone_i < cone_count; ++cone_i) {
+		const Vector4 &cone = cones[cone_i];
+		Ref<IKLimitCone3D> new_cone;
+		new_cone.instantiate();
+		new_cone->set_radius(MAX(1.0e-38, cone.w));
+		new_cone->set_control_point(Vector3(cone.x, cone.y, cone.z).normalized());
+		// Attached last, so the kusudama compiles its cones once per added cone rather than on every setter.
+		new_cone->set_attached_to(constraint);
+		constraint->add_open_cone(new_cone);
+	}
+
+	const Vector2 axial_limit = get_joint_twist(p_constraint_index);
+	constraint->enable_axial_limits();
+	constraint->set_axial_limits(axial_limit.x, axial_limit.y);
+	constraint->set_resistance(get_kusudama_resistance(p_constraint_index));
+	p_ik_bone->add_constraint(constraint);
+	p_ik_bone->update_returnfulness(get_iterations_per_frame());
+	constraint->_update_constraint(p_ik_bone->get_constraint_twist_transform());
 }
 
 int32_t ManyBoneIK3D::find_constraint(String p_string) const {
@@ -746,6 +1290,7 @@ void ManyBoneIK3D::remove_pin_at_index(int32_t p_index) {
 	kusudama_open_cone_count.remove_at(p_index);
 	kusudama_open_cones.remove_at(p_index);
 	joint_twist.remove_at(p_index);
+	kusudama_resistance.remove_at(p_index);
 
 	constraint_count--;
 
@@ -758,7 +1303,7 @@ void ManyBoneIK3D::_set_bone_count(int32_t p_count) {
 		bone_damp.write[bone_i] = get_default_damp();
 	}
 	bone_count = p_count;
-	set_dirty();
+	_mark_dirty(DIRTY_DAMPING);
 	notify_property_list_changed();
 }
 
@@ -956,13 +1501,430 @@ void ManyBoneIK3D::set_ui_selected_bone(int32_t p_ui_selected_bone) {
 
 void ManyBoneIK3D::set_stabilization_passes(int32_t p_passes) {
 	stabilize_passes = p_passes;
-	set_dirty();
+	_mark_dirty(DIRTY_DAMPING);
 }
 
 int32_t ManyBoneIK3D::get_stabilization_passes() {
 	return stabilize_passes;
 }
 
+void ManyBoneIK3D::set_thread_count(int32_t p_thread_count) {
+	thread_count = MAX(p_thread_count, 1);
+}
+
+int32_t ManyBoneIK3D::get_thread_count() const {
+	return thread_count;
+}
+
+void ManyBoneIK3D::set_parallel_child_segments(bool p_enabled) {
+	parallel_child_segments = p_enabled;
+}
+
+bool ManyBoneIK3D::is_parallel_child_segments() const {
+	return parallel_child_segments;
+}
+
+void ManyBoneIK3D::set_convergence_enabled(bool p_enabled) {
+	convergence_enabled = p_enabled;
+}
+
+bool ManyBoneIK3D::is_convergence_enabled() const {
+	return convergence_enabled;
+}
+
+void ManyBoneIK3D::set_convergence_epsilon(double p_epsilon) {
+	convergence_epsilon = MAX(p_epsilon, 0.0);
+}
+
+double ManyBoneIK3D::get_convergence_epsilon() const {
+	return convergence_epsilon;
+}
+
+void ManyBoneIK3D::set_convergence_threshold(double p_threshold) {
+	convergence_threshold = MAX(p_threshold, 0.0);
+}
+
+double ManyBoneIK3D::get_convergence_threshold() const {
+	return convergence_threshold;
+}
+
+void ManyBoneIK3D::set_solver_precision(SolverPrecision p_precision) {
+	solver_precision = p_precision;
+}
+
+ManyBoneIK3D::SolverPrecision ManyBoneIK3D::get_solver_precision() const {
+	return solver_precision;
+}
+
+void ManyBoneIK3D::set_constraint_bounds_grid_resolution(int32_t p_resolution) {
+	constraint_bounds_grid_resolution = MAX(p_resolution, 0);
+	for (int32_t constraint_i = 0; constraint_i < constraint_count; constraint_i++) {
+		_mark_constraint_dirty(constraint_i);
+	}
+}
+
+int32_t ManyBoneIK3D::get_constraint_bounds_grid_resolution() const {
+	return constraint_bounds_grid_resolution;
+}
+
+int64_t ManyBoneIK3D::get_constraint_bounds_grid_memory_usage() const {
+	int64_t memory_usage = 0;
+	for (const Ref<IKBone3D> &ik_bone : bone_list) {
+		if (ik_bone.is_valid() && ik_bone->get_constraint().is_valid()) {
+			memory_usage += ik_bone->get_constraint()->get_bounds_grid_memory_usage();
+		}
+	}
+	return memory_usage;
+}
+
+bool ManyBoneIK3D::_get_bone_constraint_violation(const Ref<IKBone3D> &p_bone, const Transform3D &p_pose, real_t &r_swing, real_t &r_twist) const {
+	r_swing = 0;
+	r_twist = 0;
+	if (p_bone.is_null() || p_bone->get_parent().is_null()) {
+		return false;
+	}
+	// Measured through the const interface, so checking a pose never touches the constraint's compiled cones.
+	const IKKusudama3D *constraint = p_bone->get_constraint().ptr();
+	const IKTransformStore3D *store = p_bone->get_transform_store();
+	if (constraint == nullptr || store == nullptr) {
+		return false;
+	}
+	const int32_t orientation_handle = p_bone->get_constraint_orientation_handle();
+	const int32_t twist_handle = p_bone->get_constraint_twist_handle();
+	const int32_t direction_handle = p_bone->get_bone_direction_handle();
+	if (orientation_handle == -1 || twist_handle == -1 || direction_handle == -1) {
+		return false;
+	}
+	// The limiting frames are children of the parent bone, so measuring in the parent's space makes the parent's own
+	// pose irrelevant and each bone can be checked on its own.
+	Transform3D limiting_axes = store->get_transform(orientation_handle);
+	if (store->is_scale_disabled(orientation_handle)) {
+		limiting_axes.basis.orthogonalize();
+	}
+	Transform3D twist_axes = store->get_transform(twist_handle);
+	if (store->is_scale_disabled(twist_handle)) {
+		twist_axes.basis.orthogonalize();
+	}
+	IKConstraintFrames3D frames;
+	constraint->compute_constraint_frames(limiting_axes, twist_axes, frames);
+	Vector3 tip = p_pose.xform(store->get_transform(direction_handle).xform(Vector3(0, 1, 0)));
+	constraint->get_limit_violation(frames, p_pose.basis, tip, r_swing, r_twist);
+	return true;
+}
+
+int32_t ManyBoneIK3D::get_constraint_violations(const Transform3D *p_bone_poses, int32_t p_pose_count, real_t *r_swing_violations, real_t *r_twist_violations, real_t p_tolerance) const {
+	ERR_FAIL_COND_V(p_bone_poses == nullptr && p_pose_count > 0, 0);
+	for (int32_t pose_i = 0; pose_i < p_pose_count; pose_i++) {
+		if (r_swing_violations) {
+			r_swing_violations[pose_i] = 0;
+		}
+		if (r_twist_violations) {
+			r_twist_violations[pose_i] = 0;
+		}
+	}
+	int32_t violation_count = 0;
+	for (const Ref<IKBone3D> &ik_bone : bone_list) {
+		if (ik_bone.is_null()) {
+			continue;
+		}
+		BoneId bone_id = ik_bone->get_bone_id();
+		if (bone_id < 0 || bone_id >= p_pose_count) {
+			continue;
+		}
+		real_t swing = 0, twist = 0;
+		if (!_get_bone_constraint_violation(ik_bone, p_bone_poses[bone_id], swing, twist)) {
+			continue;
+		}
+		if (r_swing_violations) {
+			r_swing_violations[bone_id] = swing;
+		}
+		if (r_twist_violations) {
+			r_twist_violations[bone_id] = twist;
+		}
+		if (swing > p_tolerance || twist > p_tolerance) {
+			violation_count++;
+		}
+	}
+	return violation_count;
+}
+
+int32_t ManyBoneIK3D::get_skeleton_constraint_violations(const Skeleton3D *p_skeleton, real_t *r_swing_violations, real_t *r_twist_violations, real_t p_tolerance) const {
+	ERR_FAIL_NULL_V(p_skeleton, 0);
+	const int32_t bone_count = p_skeleton->get_bone_count();
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		if (r_swing_violations) {
+			r_swing_violations[bone_i] = 0;
+		}
+		if (r_twist_violations) {
+			r_twist_violations[bone_i] = 0;
+		}
+	}
+	int32_t violation_count = 0;
+	for (const Ref<IKBone3D> &ik_bone : bone_list) {
+		if (ik_bone.is_null()) {
+			continue;
+		}
+		BoneId bone_id = ik_bone->get_bone_id();
+		if (bone_id < 0 || bone_id >= bone_count) {
+			continue;
+		}
+		real_t swing = 0, twist = 0;
+		if (!_get_bone_constraint_violation(ik_bone, p_skeleton->get_bone_pose(bone_id), swing, twist)) {
+			continue;
+		}
+		if (r_swing_violations) {
+			r_swing_violations[bone_id] = swing;
+		}
+		if (r_twist_violations) {
+			r_twist_violations[bone_id] = twist;
+		}
+		if (swing > p_tolerance || twist > p_tolerance) {
+			violation_count++;
+		}
+	}
+	return violation_count;
+}
+
+bool ManyBoneIK3D::is_pose_within_constraints(const TypedArray<Transform3D> &p_bone_poses, real_t p_tolerance) const {
+	const int32_t pose_count = p_bone_poses.size();
+	for (const Ref<IKBone3D> &ik_bone : bone_list) {
+		if (ik_bone.is_null() || ik_bone->get_bone_id() < 0 || ik_bone->get_bone_id() >= pose_count) {
+			continue;
+		}
+		real_t swing = 0, twist = 0;
+		_get_bone_constraint_violation(ik_bone, p_bone_poses[ik_bone->get_bone_id()], swing, twist);
+		if (swing > p_tolerance || twist > p_tolerance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ManyBoneIK3D::is_skeleton_pose_within_constraints(Skeleton3D *p_skeleton, real_t p_tolerance) const {
+	ERR_FAIL_NULL_V(p_skeleton, false);
+	return get_skeleton_constraint_violations(p_skeleton, nullptr, nullptr, p_tolerance) == 0;
+}
+
+PackedFloat32Array ManyBoneIK3D::get_pose_constraint_violations(const TypedArray<Transform3D> &p_bone_poses) const {
+	const int32_t pose_count = p_bone_poses.size();
+	PackedFloat32Array violations;
+	violations.resize(pose_count * 2);
+	violations.fill(0);
+	float *violations_ptr = violations.ptrw();
+	for (const Ref<IKBone3D> &ik_bone : bone_list) {
+		if (ik_bone.is_null() || ik_bone->get_bone_id() < 0 || ik_bone->get_bone_id() >= pose_count) {
+			continue;
+		}
+		real_t swing = 0, twist = 0;
+		_get_bone_constraint_violation(ik_bone, p_bone_poses[ik_bone->get_bone_id()], swing, twist);
+		violations_ptr[ik_bone->get_bone_id() * 2] = swing;
+		violations_ptr[ik_bone->get_bone_id() * 2 + 1] = twist;
+	}
+	return violations;
+}
+
+int32_t ManyBoneIK3D::get_last_iteration_count() const {
+	int32_t iteration_count = 0;
+	for (const Ref<IKBoneSegment3D> &segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_valid()) {
+			iteration_count = MAX(iteration_count, segmented_skeleton->get_last_iteration_count());
+		}
+	}
+	return iteration_count;
+}
+
+double ManyBoneIK3D::get_last_solve_error() const {
+	double error = -1.0;
+	for (const Ref<IKBoneSegment3D> &segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_valid()) {
+			error = MAX(error, segmented_skeleton->get_last_error());
+		}
+	}
+	return error;
+}
+
+Dictionary ManyBoneIK3D::get_solver_stats() const {
+	Dictionary stats;
+#ifdef DEBUG_ENABLED
+	stats["rebuild_usec"] = solver_stats.rebuild_usec;
+	stats["solve_usec"] = solver_stats.solve_usec;
+	stats["qcp_usec"] = solver_stats.qcp_usec;
+	stats["snap_usec"] = solver_stats.snap_usec;
+	stats["write_back_usec"] = solver_stats.write_back_usec;
+	stats["iterations"] = solver_stats.iterations;
+	stats["stabilization_rollbacks"] = solver_stats.stabilization_rollbacks;
+	stats["constraint_snaps"] = solver_stats.constraint_snaps;
+	stats["effector_errors"] = solver_stats.effector_errors;
+#endif
+	return stats;
+}
+
+#ifdef DEBUG_ENABLED
+LocalVector<ManyBoneIK3D *> ManyBoneIK3D::monitored_instances;
+
+// Indexed by ManyBoneIK3D::SolverMonitor.
+static const char *solver_monitor_names[] = {
+	"ManyBoneIK3D/rebuild_usec",
+	"ManyBoneIK3D/solve_usec",
+	"ManyBoneIK3D/qcp_usec",
+	"ManyBoneIK3D/snap_usec",
+	"ManyBoneIK3D/write_back_usec",
+	"ManyBoneIK3D/iterations",
+	"ManyBoneIK3D/stabilization_rollbacks",
+	"ManyBoneIK3D/constraint_snaps",
+};
+
+void ManyBoneIK3D::_finish_solver_stats() {
+	IKBoneSegment3D::SolverStats segment_stats;
+	for (const Ref<IKBoneSegment3D> &segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_valid()) {
+			segmented_skeleton->accumulate_solver_stats(segment_stats);
+		}
+	}
+	solver_stats.rebuild_usec = pending_stats.rebuild_usec;
+	solver_stats.write_back_usec = pending_stats.write_back_usec;
+	solver_stats.solve_usec = segment_stats.solve_usec;
+	solver_stats.qcp_usec = segment_stats.qcp_usec;
+	solver_stats.snap_usec = segment_stats.snap_usec;
+	solver_stats.stabilization_rollbacks = segment_stats.stabilization_rollbacks;
+	solver_stats.constraint_snaps = segment_stats.constraint_snaps;
+	solver_stats.iterations = get_last_iteration_count();
+	pending_stats.rebuild_usec = 0;
+	pending_stats.write_back_usec = 0;
+
+	// Distance from each pinned bone to its target after the solve, in pin order. Unresolved pins report -1.
+	// The buffer keeps its size across frames, so it is only reallocated when the pin count changes.
+	if (solver_stats.effector_errors.size() != pins.size()) {
+		solver_stats.effector_errors.resize(pins.size());
+	}
+	double *effector_errors = solver_stats.effector_errors.ptrw();
+	for (int32_t pin_i = 0; pin_i < pins.size(); pin_i++) {
+		double error = -1.0;
+		if (uint32_t(pin_i) < pin_effectors.size() && pin_effectors[pin_i].is_valid()) {
+			const Ref<IKEffector3D> &effector = pin_effectors[pin_i];
+			error = effector->get_target_global_transform().origin.distance_to(effector->get_ik_bone_3d()->get_bone_direction_global_pose().origin);
+		}
+		effector_errors[pin_i] = error;
+	}
+}
+
+void ManyBoneIK3D::_add_monitored_instance(ManyBoneIK3D *p_instance) {
+	if (monitored_instances.has(p_instance)) {
+		return;
+	}
+	monitored_instances.push_back(p_instance);
+	Performance *performance = Performance::get_singleton();
+	if (monitored_instances.size() != 1 || !performance) {
+		return;
+	}
+	for (int monitor_i = 0; monitor_i < MONITOR_MAX; monitor_i++) {
+		if (!performance->has_custom_monitor(solver_monitor_names[monitor_i])) {
+			performance->add_custom_monitor(solver_monitor_names[monitor_i], callable_mp_static(&ManyBoneIK3D::_get_solver_monitor).bind(monitor_i), Vector<Variant>());
+		}
+	}
+}
+
+void ManyBoneIK3D::_remove_monitored_instance(ManyBoneIK3D *p_instance) {
+	if (!monitored_instances.has(p_instance)) {
+		return;
+	}
+	monitored_instances.erase(p_instance);
+	Performance *performance = Performance::get_singleton();
+	if (!monitored_instances.is_empty() || !performance) {
+		return;
+	}
+	for (int monitor_i = 0; monitor_i < MONITOR_MAX; monitor_i++) {
+		if (performance->has_custom_monitor(solver_monitor_names[monitor_i])) {
+			performance->remove_custom_monitor(solver_monitor_names[monitor_i]);
+		}
+	}
+}
+
+double ManyBoneIK3D::_get_solver_monitor(int p_monitor) {
+	// Monitors report the sum over every solver in the tree for their last finished frame.
+	double total = 0.0;
+	for (const ManyBoneIK3D *instance : monitored_instances) {
+		const SolverStats &stats = instance->solver_stats;
+		switch (p_monitor) {
+			case MONITOR_REBUILD_USEC:
+				total += stats.rebuild_usec;
+				break;
+			case MONITOR_SOLVE_USEC:
+				total += stats.solve_usec;
+				break;
+			case MONITOR_QCP_USEC:
+				total += stats.qcp_usec;
+				break;
+			case MONITOR_SNAP_USEC:
+				total += stats.snap_usec;
+				break;
+			case MONITOR_WRITE_BACK_USEC:
+				total += stats.write_back_usec;
+				break;
+			case MONITOR_ITERATIONS:
+				total += stats.iterations;
+				break;
+			case MONITOR_STABILIZATION_ROLLBACKS:
+				total += stats.stabilization_rollbacks;
+				break;
+			case MONITOR_CONSTRAINT_SNAPS:
+				total += stats.constraint_snaps;
+				break;
+		}
+	}
+	return total;
+}
+#endif
+
+void ManyBoneIK3D::set_batched_solve(bool p_enabled) {
+	if (batched_solve == p_enabled) {
+		return;
+	}
+	batched_solve = p_enabled;
+	_drop_batch_result();
+	IKSolveServer3D *solve_server = IKSolveServer3D::get_singleton();
+	if (!solve_server || !is_inside_tree()) {
+		return;
+	}
+	if (batched_solve) {
+		solve_server->register_modifier(this);
+	} else {
+		solve_server->unregister_modifier(this);
+	}
+}
+
+bool ManyBoneIK3D::is_batched_solve() const {
+	return batched_solve;
+}
+
+void ManyBoneIK3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_ENTER_TREE: {
+			if (batched_solve && IKSolveServer3D::get_singleton()) {
+				IKSolveServer3D::get_singleton()->register_modifier(this);
+			}
+			// Effector targets are looked up by path once and cached. Each target drops its cache when it leaves the tree,
+			// and renaming it or one of its ancestors is caught here, so unrelated tree changes keep the caches.
+			get_tree()->connect(SNAME("node_renamed"), callable_mp(this, &ManyBoneIK3D::_on_node_renamed));
+			_clear_target_node_caches();
+#ifdef DEBUG_ENABLED
+			_add_monitored_instance(this);
+#endif
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+			if (IKSolveServer3D::get_singleton()) {
+				IKSolveServer3D::get_singleton()->unregister_modifier(this);
+			}
+			get_tree()->disconnect(SNAME("node_renamed"), callable_mp(this, &ManyBoneIK3D::_on_node_renamed));
+			_clear_target_node_caches();
+			_drop_batch_result();
+#ifdef DEBUG_ENABLED
+			_remove_monitored_instance(this);
+#endif
+		} break;
+	}
+}
+
 Transform3D ManyBoneIK3D::get_godot_skeleton_transform_inverse() {
 	return godot_skeleton_transform_inverse;
 }
@@ -979,6 +1941,7 @@ void ManyBoneIK3D::add_constraint() {
 	kusudama_open_cones.write[old_count].resize(1);
 	kusudama_open_cones.write[old_count].write[0] = Vector4(0, 1, 0, Math_PI);
 	joint_twist.write[old_count] = Vector2(0, Math_PI);
+	kusudama_resistance.write[old_count] = 0.0f;
 	set_dirty();
 }
 
@@ -997,14 +1960,21 @@ void ManyBoneIK3D::_bone_list_changed() {
 	if (roots.is_empty()) {
 		return;
 	}
+#ifdef DEBUG_ENABLED
+	uint64_t rebuild_begin = OS::get_singleton()->get_ticks_usec();
+#endif
+	dirty_flags = DIRTY_NONE;
+	dirty_constraints.clear();
 	bone_list.clear();
 	segmented_skeletons.clear();
+	pin_effectors.clear();
 	for (BoneId root_bone_index : roots) {
 		String parentless_bone = skeleton->get_bone_name(root_bone_index);
 		Ref<IKBoneSegment3D> segmented_skeleton = Ref<IKBoneSegment3D>(memnew(IKBoneSegment3D(skeleton, parentless_bone, pins, this, nullptr, root_bone_index, -1, stabilize_passes)));
 		ik_origin.instantiate();
 		segmented_skeleton->get_root()->get_ik_transform()->set_parent(ik_origin);
 		segmented_skeleton->generate_default_segments(pins, root_bone_index, -1, this);
+		segmented_skeleton->create_transform_store(ik_origin);
 		Vector<Ref<IKBone3D>> new_bone_list;
 		segmented_skeleton->create_bone_list(new_bone_list, true);
 		bone_list.append_array(new_bone_list);
@@ -1013,6 +1983,7 @@ void ManyBoneIK3D::_bone_list_changed() {
 		segmented_skeleton->recursive_create_headings_arrays_for(segmented_skeleton);
 		segmented_skeletons.push_back(segmented_skeleton);
 	}
+	_update_pin_effectors();
 	_update_ik_bones_transform();
 	for (Ref<IKBone3D> &ik_bone_3d : bone_list) {
 		ik_bone_3d->update_default_bone_direction_transform(skeleton);
@@ -1024,30 +1995,13 @@ void ManyBoneIK3D::_bone_list_changed() {
 			if (ik_bone_3d->get_bone_id() != bone_id) {
 				continue;
 			}
-			Ref<IKKusudama3D> constraint;
-			constraint.instantiate();
-			constraint->enable_orientational_limits();
-
-			int32_t cone_count = kusudama_open_cone_count[constraint_i];
-			const Vector<Vector4> &cones = kusudama_open_cones[constraint_i];
-			for (int32_t cone_i = 0; cone_i < cone_count; ++cone_i) {
-				const Vector4 &cone = cones[cone_i];
-				Ref<IKLimitCone3D> new_cone;
-				new_cone.instantiate();
-				new_cone->set_attached_to(constraint);
-				new_cone->set_radius(MAX(1.0e-38, cone.w));
-				new_cone->set_control_point(Vector3(cone.x, cone.y, cone.z).normalized());
-				constraint->add_open_cone(new_cone);
-			}
-
-			const Vector2 axial_limit = get_joint_twist(constraint_i);
-			constraint->enable_axial_limits();
-			constraint->set_axial_limits(axial_limit.x, axial_limit.y);
-			ik_bone_3d->add_constraint(constraint);
-			constraint->_update_constraint(ik_bone_3d->get_constraint_twist_transform());
+			_build_constraint(constraint_i, ik_bone_3d);
 			break;
 		}
 	}
+#ifdef DEBUG_ENABLED
+	pending_stats.rebuild_usec += OS::get_singleton()->get_ticks_usec() - rebuild_begin;
+#endif
 }
 
 void ManyBoneIK3D::_skeleton_changed(Skeleton3D *p_old, Skeleton3D *p_new) {
@@ -35,24 +35,39 @@
 #include "core/math/transform_3d.h"
 #include "core/math/vector3.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
 #include "ik_bone_3d.h"
+#include "ik_effector_3d.h"
 #include "ik_effector_template_3d.h"
 #include "math/ik_node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/3d/skeleton_modifier_3d.h"
 
 class ManyBoneIK3DState;
+class IKSolveServer3D;
 class ManyBoneIK3D : public SkeletonModifier3D {
 	GDCLASS(ManyBoneIK3D, SkeletonModifier3D);
+	friend class IKSolveServer3D;
 
+public:
+	enum SolverPrecision {
+		SOLVER_PRECISION_DOUBLE,
+		SOLVER_PRECISION_FLOAT,
+	};
+
+private:
 	bool is_constraint_mode = false;
 	NodePath skeleton_path;
 	Vector<Ref<IKBoneSegment3D>> segmented_skeletons;
 	int32_t constraint_count = 0, pin_count = 0, bone_count = 0;
 	Vector<StringName> constraint_names;
 	Vector<Ref<IKEffectorTemplate3D>> pins;
+	LocalVector<Ref<IKEffector3D>> pin_effectors; // The built effector of each pin, indexed like pins and refreshed on rebuild.
 	Vector<Ref<IKBone3D>> bone_list;
 	Vector<Vector2> joint_twist;
+	Vector<float> kusudama_resistance;
 	Vector<float> bone_damp;
 	Vector<Vector<Vector4>> kusudama_open_cones;
 	Vector<int> kusudama_open_cone_count;
@@ -62,12 +77,79 @@ class ManyBoneIK3D : public SkeletonModifier3D {
 	Ref<IKNode3D> godot_skeleton_transform;
 	Transform3D godot_skeleton_transform_inverse;
 	Ref<IKNode3D> ik_origin;
-	bool is_dirty = true;
+	enum DirtyFlags {
+		DIRTY_NONE = 0,
+		DIRTY_TOPOLOGY = 1 << 0, // Bones or pinned bone names changed; segments must be regenerated.
+		DIRTY_EFFECTORS = 1 << 1,
+		DIRTY_CONSTRAINTS = 1 << 2,
+		DIRTY_DAMPING = 1 << 3,
+	};
+	uint32_t dirty_flags = DIRTY_TOPOLOGY;
+	HashSet<int32_t> dirty_constraints;
 	NodePath skeleton_node_path = NodePath("..");
 	int32_t ui_selected_bone = -1, stabilize_passes = 0;
+	int32_t thread_count = 1;
+	int32_t constraint_bounds_grid_resolution = 0;
+	bool parallel_child_segments = false;
+	bool convergence_enabled = false;
+	double convergence_epsilon = 1e-6;
+	double convergence_threshold = 1e-4;
+	SolverPrecision solver_precision = SOLVER_PRECISION_DOUBLE;
+
+	struct SolveParameters {
+		int32_t iterations = 0;
+		float default_damp = 0.0f;
+		bool constraint_mode = false;
+		bool parallel_child_segments = false;
+		bool convergence_enabled = false;
+		double convergence_epsilon = 0.0;
+		double convergence_threshold = 0.0;
+		SolverPrecision solver_precision = SOLVER_PRECISION_DOUBLE;
+	};
+	bool batched_solve = false;
+	bool batch_solved = false; // Set when the solve server already solved this modifier and the result awaits write-back.
+	uint64_t batch_frame = 0; // The solve server frame batch_solved belongs to; older results are solved again.
+	SolveParameters batch_parameters;
+#ifdef DEBUG_ENABLED
+	struct SolverStats {
+		uint64_t rebuild_usec = 0;
+		uint64_t solve_usec = 0;
+		uint64_t qcp_usec = 0;
+		uint64_t snap_usec = 0;
+		uint64_t write_back_usec = 0;
+		int32_t iterations = 0;
+		uint32_t stabilization_rollbacks = 0;
+		uint32_t constraint_snaps = 0;
+		PackedFloat64Array effector_errors;
+	};
+	enum SolverMonitor {
+		MONITOR_REBUILD_USEC,
+		MONITOR_SOLVE_USEC,
+		MONITOR_QCP_USEC,
+		MONITOR_SNAP_USEC,
+		MONITOR_WRITE_BACK_USEC,
+		MONITOR_ITERATIONS,
+		MONITOR_STABILIZATION_ROLLBACKS,
+		MONITOR_CONSTRAINT_SNAPS,
+		MONITOR_MAX,
+	};
+	SolverStats pending_stats; // Phases timed outside the segment solve, collected until the frame finishes.
+	SolverStats solver_stats; // The last finished frame.
+	static LocalVector<ManyBoneIK3D *> monitored_instances;
+	void _finish_solver_stats();
+	static void _add_monitored_instance(ManyBoneIK3D *p_instance);
+	static void _remove_monitored_instance(ManyBoneIK3D *p_instance);
+	static double _get_solver_monitor(int p_monitor);
+#endif
 
 	void _on_timer_timeout();
 	void _update_ik_bones_transform();
+	void _clear_target_node_caches();
+	void _on_node_renamed(Node *p_node);
+	void _update_pin_effectors();
+	Ref<IKEffector3D> _get_built_pin_effector(int32_t p_pin_index) const;
+	void _set_pin_target_transforms_bind(const PackedFloat32Array &p_transforms);
+	void _set_pin_target_transform_array_bind(const TypedArray<Transform3D> &p_transforms);
 	void _update_skeleton_bones_transform();
 	Vector<Ref<IKEffectorTemplate3D>> _get_bone_effectors() const;
 	void set_constraint_name_at_index(int32_t p_index, String p_name);
@@ -77,10 +159,23 @@ class ManyBoneIK3D : public SkeletonModifier3D {
 	void _set_pin_root_bone(int32_t p_pin_index, const String &p_root_bone);
 	String _get_pin_root_bone(int32_t p_pin_index) const;
 	void _bone_list_changed();
+	void _mark_dirty(DirtyFlags p_flag);
+	void _mark_constraint_dirty(int32_t p_index);
+	void _update_dirty_effectors();
+	void _update_dirty_constraints();
+	void _update_dirty_damping();
+	void _build_constraint(int32_t p_constraint_index, Ref<IKBone3D> p_ik_bone);
 	void _pose_updated();
 	void _update_ik_bone_pose(int32_t p_bone_idx);
+	void _solve_root_segment(uint32_t p_index, const SolveParameters *p_parameters);
+	SolveParameters _get_solve_parameters() const;
+	bool _begin_batched_solve();
+	bool _has_current_batch_result() const;
+	void _drop_batch_result();
+	bool _get_bone_constraint_violation(const Ref<IKBone3D> &p_bone, const Transform3D &p_pose, real_t &r_swing, real_t &r_twist) const;
 
 protected:
+	void _notification(int p_what);
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
 	void _get_property_list(List<PropertyInfo> *p_list) const;
@@ -94,6 +189,35 @@ public:
 	void add_constraint();
 	void set_stabilization_passes(int32_t p_passes);
 	int32_t get_stabilization_passes();
+	void set_thread_count(int32_t p_thread_count);
+	int32_t get_thread_count() const;
+	void set_parallel_child_segments(bool p_enabled);
+	bool is_parallel_child_segments() const;
+	void set_batched_solve(bool p_enabled);
+	bool is_batched_solve() const;
+	void set_convergence_enabled(bool p_enabled);
+	bool is_convergence_enabled() const;
+	void set_convergence_epsilon(double p_epsilon);
+	double get_convergence_epsilon() const;
+	void set_convergence_threshold(double p_threshold);
+	double get_convergence_threshold() const;
+	void set_solver_precision(SolverPrecision p_precision);
+	SolverPrecision get_solver_precision() const;
+	int32_t get_last_iteration_count() const;
+	double get_last_solve_error() const;
+	Dictionary get_solver_stats() const;
+	void set_constraint_bounds_grid_resolution(int32_t p_resolution);
+	int32_t get_constraint_bounds_grid_resolution() const;
+	int64_t get_constraint_bounds_grid_memory_usage() const;
+	// How far bone poses are outside the built constraints, without running the solver. p_bone_poses holds one pose per
+	// skeleton bone, relative to its parent as Skeleton3D::get_bone_pose() returns it. When given, r_swing_violations and
+	// r_twist_violations receive one angle per pose, 0 within the limits. Returns the number of bones outside the limits
+	// by more than p_tolerance. Allocates nothing.
+	int32_t get_constraint_violations(const Transform3D *p_bone_poses, int32_t p_pose_count, real_t *r_swing_violations = nullptr, real_t *r_twist_violations = nullptr, real_t p_tolerance = 0.0) const;
+	int32_t get_skeleton_constraint_violations(const Skeleton3D *p_skeleton, real_t *r_swing_violations = nullptr, real_t *r_twist_violations = nullptr, real_t p_tolerance = 0.0) const;
+	bool is_pose_within_constraints(const TypedArray<Transform3D> &p_bone_poses, real_t p_tolerance = 0.0) const;
+	bool is_skeleton_pose_within_constraints(Skeleton3D *p_skeleton, real_t p_tolerance = 0.0) const;
+	PackedFloat32Array get_pose_constraint_violations(const TypedArray<Transform3D> &p_bone_poses) const;
 	Transform3D get_godot_skeleton_transform_inverse();
 	Ref<IKNode3D> get_godot_skeleton_transform();
 	void set_ui_selected_bone(int32_t p_ui_selected_bone);
@@ -121,7 +245,23 @@ public:
 	real_t get_pin_weight(int32_t p_pin_index) const;
 	void set_pin_direction_priorities(int32_t p_pin_index, const Vector3 &p_priority_direction);
 	Vector3 get_pin_direction_priorities(int32_t p_pin_index) const;
+	void set_pin_target_static(int32_t p_pin_index, bool p_static);
+	// Blend weight and distance falloff scale the pin's weight at solve time and never trigger a rebuild, so they can be animated.
+	void set_pin_blend_weight(int32_t p_pin_index, real_t p_blend_weight);
+	real_t get_pin_blend_weight(int32_t p_pin_index) const;
+	void set_pin_weight_falloff_curve(int32_t p_pin_index, const Ref<Curve> &p_curve);
+	Ref<Curve> get_pin_weight_falloff_curve(int32_t p_pin_index) const;
+	void set_pin_weight_falloff_distance(int32_t p_pin_index, real_t p_distance);
+	real_t get_pin_weight_falloff_distance(int32_t p_pin_index) const;
+	bool is_pin_target_static(int32_t p_pin_index) const;
 	NodePath get_pin_target_node_path(int32_t p_pin_index);
+	// Feeds a pin's target directly, relative to the skeleton, instead of reading it from the target node.
+	// Takes effect without a rebuild, and the scene tree is not touched for the pin until clear_pin_target_transform().
+	void set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform);
+	Transform3D get_pin_target_transform(int32_t p_pin_index) const;
+	void clear_pin_target_transform(int32_t p_pin_index);
+	// Feeds the targets of the first p_count pins in pin order.
+	void set_pin_target_transforms(const Transform3D *p_transforms, int32_t p_count);
 	void set_pin_motion_propagation_factor(int32_t p_effector_index, const float p_motion_propagation_factor);
 	float get_pin_motion_propagation_factor(int32_t p_effector_index) const;
 	real_t get_default_damp() const;
@@ -138,6 +278,8 @@ public:
 	Transform3D get_direction_transform_of_bone(int32_t p_index) const;
 	Vector2 get_joint_twist(int32_t p_index) const;
 	void set_joint_twist(int32_t p_index, Vector2 p_twist);
+	float get_kusudama_resistance(int32_t p_index) const;
+	void set_kusudama_resistance(int32_t p_index, float p_resistance);
 	void set_kusudama_open_cone(int32_t p_bone, int32_t p_index,
 			Vector3 p_center, float p_radius);
 	Vector3 get_kusudama_open_cone_center(int32_t p_constraint_index, int32_t p_index) const;
@@ -153,4 +295,6 @@ public:
 	void set_dirty();
 };
 
+VARIANT_ENUM_CAST(ManyBoneIK3D::SolverPrecision);
+
 #endif // MANY_BONE_IK_3D_H
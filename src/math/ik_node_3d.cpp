@@ -31,21 +31,23 @@
 #include "ik_node_3d.h"
 
 void IKNode3D::_propagate_transform_changed() {
-	Vector<Ref<IKNode3D>> to_remove;
+	if (store.is_valid()) {
+		// The store dirties the bound subtree itself, but unbound children still cache their own globals.
+		store->mark_dirty(handle);
+	} else {
+		dirty |= DIRTY_GLOBAL;
+	}
 
-	for (Ref<IKNode3D> transform : children) {
-		if (transform.is_null()) {
-			to_remove.push_back(transform);
+	List<Ref<IKNode3D>>::Element *E = children.front();
+	while (E) {
+		List<Ref<IKNode3D>>::Element *next = E->next();
+		if (E->get().is_null()) {
+			children.erase(E);
 		} else {
-			transform->_propagate_transform_changed();
+			E->get()->_propagate_transform_changed();
 		}
+		E = next;
 	}
-
-	for (Ref<IKNode3D> transform : to_remove) {
-		children.erase(transform);
-	}
-
-	dirty |= DIRTY_GLOBAL;
 }
 
 void IKNode3D::_update_local_transform() const {
@@ -54,6 +56,13 @@ void IKNode3D::_update_local_transform() const {
 }
 
 void IKNode3D::rotate_local_with_global(const Basis &p_basis, bool p_propagate) {
+	if (store.is_valid()) {
+		store->rotate_local_with_global(handle, p_basis);
+		if (p_propagate) {
+			_propagate_transform_changed();
+		}
+		return;
+	}
 	if (parent.get_ref().is_null()) {
 		return;
 	}
@@ -67,6 +76,13 @@ void IKNode3D::rotate_local_with_global(const Basis &p_basis, bool p_propagate)
 }
 
 void IKNode3D::set_transform(const Transform3D &p_transform) {
+	if (store.is_valid()) {
+		if (store->get_transform(handle) != p_transform) {
+			store->set_transform(handle, p_transform);
+			_propagate_transform_changed();
+		}
+		return;
+	}
 	if (local_transform != p_transform) {
 		local_transform = p_transform;
 		dirty |= DIRTY_VECTORS;
@@ -75,6 +91,11 @@ void IKNode3D::set_transform(const Transform3D &p_transform) {
 }
 
 void IKNode3D::set_global_transform(const Transform3D &p_transform) {
+	if (store.is_valid()) {
+		store->set_global_transform(handle, p_transform);
+		_propagate_transform_changed();
+		return;
+	}
 	Ref<IKNode3D> ik_node = parent.get_ref();
 	Transform3D xform = ik_node.is_valid() ? ik_node->get_global_transform().affine_inverse() * p_transform : p_transform;
 	local_transform = xform;
@@ -83,6 +104,9 @@ void IKNode3D::set_global_transform(const Transform3D &p_transform) {
 }
 
 Transform3D IKNode3D::get_transform() const {
+	if (store.is_valid()) {
+		return store->get_transform(handle);
+	}
 	if (dirty & DIRTY_LOCAL) {
 		_update_local_transform();
 	}
@@ -91,6 +115,9 @@ Transform3D IKNode3D::get_transform() const {
 }
 
 Transform3D IKNode3D::get_global_transform() const {
+	if (store.is_valid()) {
+		return store->get_global_transform(handle);
+	}
 	if (dirty & DIRTY_GLOBAL) {
 		if (dirty & DIRTY_LOCAL) {
 			_update_local_transform();
@@ -114,6 +141,9 @@ Transform3D IKNode3D::get_global_transform() const {
 
 void IKNode3D::set_disable_scale(bool p_enabled) {
 	disable_scale = p_enabled;
+	if (store.is_valid()) {
+		store->set_disable_scale(handle, p_enabled);
+	}
 }
 
 bool IKNode3D::is_scale_disabled() const {
@@ -121,6 +151,8 @@ bool IKNode3D::is_scale_disabled() const {
 }
 
 void IKNode3D::set_parent(Ref<IKNode3D> p_parent) {
+	// The store's hierarchy is fixed, so reparenting turns the node back into a standalone one.
+	unbind_from_store();
 	if (p_parent.is_valid()) {
 		p_parent->children.erase(this);
 	}
@@ -136,13 +168,51 @@ Ref<IKNode3D> IKNode3D::get_parent() const {
 }
 
 Vector3 IKNode3D::to_local(const Vector3 &p_global) const {
+	if (store.is_valid()) {
+		return store->to_local(handle, p_global);
+	}
 	return get_global_transform().affine_inverse().xform(p_global);
 }
 
 Vector3 IKNode3D::to_global(const Vector3 &p_local) const {
+	if (store.is_valid()) {
+		return store->to_global(handle, p_local);
+	}
 	return get_global_transform().xform(p_local);
 }
 
+void IKNode3D::bind_to_store(const Ref<IKTransformStore3D> &p_store, int32_t p_handle) {
+	ERR_FAIL_COND(p_store.is_null());
+	ERR_FAIL_INDEX(p_handle, p_store->size());
+	Transform3D local = get_transform();
+	store = p_store;
+	handle = p_handle;
+	store->set_transform(handle, local);
+	store->set_disable_scale(handle, disable_scale);
+}
+
+void IKNode3D::unbind_from_store() {
+	if (store.is_null()) {
+		return;
+	}
+	local_transform = store->get_transform(handle);
+	dirty |= DIRTY_GLOBAL;
+	store.unref();
+	handle = -1;
+}
+
+bool IKNode3D::is_bound_to_store() const {
+	return store.is_valid();
+}
+
+Ref<IKTransformStore3D> IKNode3D::get_store() const {
+	return store;
+}
+
+int32_t IKNode3D::get_handle() const {
+	return handle;
+}
+
 IKNode3D::~IKNode3D() {
 	cleanup();
 }
@@ -33,6 +33,7 @@
 
 #include "core/object/ref_counted.h"
 #include "core/templates/list.h"
+#include "ik_transform_store_3d.h"
 
 #include "core/io/resource.h"
 #include "core/math/transform_3d.h"
@@ -59,6 +60,10 @@ class IKNode3D : public RefCounted {
 
 	bool disable_scale = false;
 
+	// When bound, the node is a view over a slot of the store and the members above are unused.
+	Ref<IKTransformStore3D> store;
+	int32_t handle = -1;
+
 	void _update_local_transform() const;
 
 protected:
@@ -95,6 +100,13 @@ public:
 	Vector3 to_local(const Vector3 &p_global) const;
 	Vector3 to_global(const Vector3 &p_local) const;
 	void rotate_local_with_global(const Basis &p_basis, bool p_propagate = false);
+
+	void bind_to_store(const Ref<IKTransformStore3D> &p_store, int32_t p_handle);
+	void unbind_from_store();
+	bool is_bound_to_store() const;
+	Ref<IKTransformStore3D> get_store() const;
+	int32_t get_handle() const;
+
 	void cleanup();
 	~IKNode3D();
 };
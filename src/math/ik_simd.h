@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  ik_simd.h                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef IK_SIMD_H
+#define IK_SIMD_H
+
+#include "core/typedefs.h"
+
+// Minimal two-lane double and four-lane float wrappers shared by the solver's structure-of-arrays kernels.
+// Only included from translation units; IK_SIMD_SSE2 or IK_SIMD_NEON tells whether a vector path exists.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IK_SIMD_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IK_SIMD_NEON
+#endif
+
+#if defined(IK_SIMD_SSE2)
+typedef __m128d ik_f64x2;
+typedef __m128d ik_mask64x2;
+typedef __m128 ik_f32x4;
+static _FORCE_INLINE_ ik_f64x2 ik_zero(double) { return _mm_setzero_pd(); }
+static _FORCE_INLINE_ ik_f64x2 ik_load(const double *p_ptr) { return _mm_loadu_pd(p_ptr); }
+static _FORCE_INLINE_ void ik_store(double *p_ptr, ik_f64x2 p_v) { _mm_storeu_pd(p_ptr, p_v); }
+static _FORCE_INLINE_ ik_f64x2 ik_splat(double p_value) { return _mm_set1_pd(p_value); }
+static _FORCE_INLINE_ ik_f64x2 ik_mul(ik_f64x2 p_a, ik_f64x2 p_b) { return _mm_mul_pd(p_a, p_b); }
+static _FORCE_INLINE_ ik_f64x2 ik_madd(ik_f64x2 p_acc, ik_f64x2 p_a, ik_f64x2 p_b) { return _mm_add_pd(p_acc, _mm_mul_pd(p_a, p_b)); }
+static _FORCE_INLINE_ ik_f64x2 ik_sqrt(ik_f64x2 p_v) { return _mm_sqrt_pd(p_v); }
+static _FORCE_INLINE_ ik_f64x2 ik_abs(ik_f64x2 p_v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), p_v); }
+static _FORCE_INLINE_ ik_mask64x2 ik_greater(ik_f64x2 p_a, ik_f64x2 p_b) { return _mm_cmpgt_pd(p_a, p_b); }
+static _FORCE_INLINE_ ik_mask64x2 ik_less_equal(ik_f64x2 p_a, ik_f64x2 p_b) { return _mm_cmple_pd(p_a, p_b); }
+static _FORCE_INLINE_ ik_f64x2 ik_select(ik_mask64x2 p_mask, ik_f64x2 p_a, ik_f64x2 p_b) { return _mm_or_pd(_mm_and_pd(p_mask, p_a), _mm_andnot_pd(p_mask, p_b)); }
+static _FORCE_INLINE_ double ik_reduce(ik_f64x2 p_v) {
+	double lanes[2];
+	_mm_storeu_pd(lanes, p_v);
+	return lanes[0] + lanes[1];
+}
+static _FORCE_INLINE_ ik_f32x4 ik_zero(float) { return _mm_setzero_ps(); }
+static _FORCE_INLINE_ ik_f32x4 ik_load(const float *p_ptr) { return _mm_loadu_ps(p_ptr); }
+static _FORCE_INLINE_ ik_f32x4 ik_mul(ik_f32x4 p_a, ik_f32x4 p_b) { return _mm_mul_ps(p_a, p_b); }
+static _FORCE_INLINE_ ik_f32x4 ik_madd(ik_f32x4 p_acc, ik_f32x4 p_a, ik_f32x4 p_b) { return _mm_add_ps(p_acc, _mm_mul_ps(p_a, p_b)); }
+static _FORCE_INLINE_ double ik_reduce(ik_f32x4 p_v) {
+	float lanes[4];
+	_mm_storeu_ps(lanes, p_v);
+	return (double(lanes[0]) + lanes[1]) + (double(lanes[2]) + lanes[3]);
+}
+#elif defined(IK_SIMD_NEON)
+typedef float64x2_t ik_f64x2;
+typedef uint64x2_t ik_mask64x2;
+typedef float32x4_t ik_f32x4;
+static _FORCE_INLINE_ ik_f64x2 ik_zero(double) { return vdupq_n_f64(0.0); }
+static _FORCE_INLINE_ ik_f64x2 ik_load(const double *p_ptr) { return vld1q_f64(p_ptr); }
+static _FORCE_INLINE_ void ik_store(double *p_ptr, ik_f64x2 p_v) { vst1q_f64(p_ptr, p_v); }
+static _FORCE_INLINE_ ik_f64x2 ik_splat(double p_value) { return vdupq_n_f64(p_value); }
+static _FORCE_INLINE_ ik_f64x2 ik_mul(ik_f64x2 p_a, ik_f64x2 p_b) { return vmulq_f64(p_a, p_b); }
+static _FORCE_INLINE_ ik_f64x2 ik_madd(ik_f64x2 p_acc, ik_f64x2 p_a, ik_f64x2 p_b) { return vfmaq_f64(p_acc, p_a, p_b); }
+static _FORCE_INLINE_ ik_f64x2 ik_sqrt(ik_f64x2 p_v) { return vsqrtq_f64(p_v); }
+static _FORCE_INLINE_ ik_f64x2 ik_abs(ik_f64x2 p_v) { return vabsq_f64(p_v); }
+static _FORCE_INLINE_ ik_mask64x2 ik_greater(ik_f64x2 p_a, ik_f64x2 p_b) { return vcgtq_f64(p_a, p_b); }
+static _FORCE_INLINE_ ik_mask64x2 ik_less_equal(ik_f64x2 p_a, ik_f64x2 p_b) { return vcleq_f64(p_a, p_b); }
+static _FORCE_INLINE_ ik_f64x2 ik_select(ik_mask64x2 p_mask, ik_f64x2 p_a, ik_f64x2 p_b) { return vbslq_f64(p_mask, p_a, p_b); }
+static _FORCE_INLINE_ double ik_reduce(ik_f64x2 p_v) { return vaddvq_f64(p_v); }
+static _FORCE_INLINE_ ik_f32x4 ik_zero(float) { return vdupq_n_f32(0.0f); }
+static _FORCE_INLINE_ ik_f32x4 ik_load(const float *p_ptr) { return vld1q_f32(p_ptr); }
+static _FORCE_INLINE_ ik_f32x4 ik_mul(ik_f32x4 p_a, ik_f32x4 p_b) { return vmulq_f32(p_a, p_b); }
+static _FORCE_INLINE_ ik_f32x4 ik_madd(ik_f32x4 p_acc, ik_f32x4 p_a, ik_f32x4 p_b) { return vfmaq_f32(p_acc, p_a, p_b); }
+static _FORCE_INLINE_ double ik_reduce(ik_f32x4 p_v) { return vaddvq_f32(p_v); }
+#endif
+
+#endif // IK_SIMD_H
@@ -0,0 +1,205 @@
+/**************************************************************************/
+/*  ik_transform_store_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_transform_store_3d.h"
+
+int32_t IKTransformStore3D::add_node(int32_t p_parent, const Transform3D &p_local) {
+	int32_t handle = local_transforms.size();
+	if (p_parent != -1) {
+		ERR_FAIL_INDEX_V(p_parent, handle, -1);
+		// Appending is only valid while the parent's subtree is the last one in the store.
+		ERR_FAIL_COND_V_MSG(subtree_ends[p_parent] != handle, -1, "Transform store nodes must be added in depth-first order.");
+	}
+	local_transforms.push_back(p_local);
+	global_transforms.push_back(p_local);
+	parents.push_back(p_parent);
+	subtree_ends.push_back(handle + 1);
+	dirty.push_back(1);
+	global_inverses.push_back(p_local.affine_inverse());
+	disable_scale.push_back(0);
+	for (int32_t ancestor = p_parent; ancestor != -1; ancestor = parents[ancestor]) {
+		subtree_ends[ancestor] = handle + 1;
+	}
+	return handle;
+}
+
+int32_t IKTransformStore3D::size() const {
+	return local_transforms.size();
+}
+
+void IKTransformStore3D::clear() {
+	local_transforms.clear();
+	global_transforms.clear();
+	parents.clear();
+	subtree_ends.clear();
+	dirty.clear();
+	global_inverses.clear();
+	disable_scale.clear();
+}
+
+int32_t IKTransformStore3D::get_parent(int32_t p_handle) const {
+	ERR_FAIL_INDEX_V(p_handle, (int32_t)parents.size(), -1);
+	return parents[p_handle];
+}
+
+int32_t IKTransformStore3D::get_subtree_end(int32_t p_handle) const {
+	ERR_FAIL_INDEX_V(p_handle, (int32_t)subtree_ends.size(), -1);
+	return subtree_ends[p_handle];
+}
+
+void IKTransformStore3D::_mark_dirty(int32_t p_handle) {
+	// A dirty node always has a dirty subtree, so there is nothing left to do.
+	if (dirty[p_handle]) {
+		return;
+	}
+	for (int32_t node_i = p_handle; node_i < subtree_ends[p_handle]; node_i++) {
+		dirty[node_i] = 1;
+	}
+}
+
+void IKTransformStore3D::_update_global(int32_t p_handle) const {
+	int32_t top = p_handle;
+	while (parents[top] != -1 && dirty[parents[top]]) {
+		top = parents[top];
+	}
+	// Every ancestor of p_handle inside the dirty subtree lies in [top, p_handle].
+	for (int32_t node_i = top; node_i <= p_handle; node_i++) {
+		if (!dirty[node_i]) {
+			continue;
+		}
+		int32_t parent = parents[node_i];
+		if (parent == -1) {
+			global_transforms[node_i] = local_transforms[node_i];
+		} else {
+			global_transforms[node_i] = global_transforms[parent] * local_transforms[node_i];
+		}
+		if (disable_scale[node_i]) {
+			global_transforms[node_i].basis.orthogonalize();
+		}
+		global_inverses[node_i] = global_transforms[node_i].affine_inverse();
+		dirty[node_i] = 0;
+	}
+}
+
+void IKTransformStore3D::update_global_transforms() const {
+	for (uint32_t node_i = 0; node_i < local_transforms.size(); node_i++) {
+		if (dirty[node_i]) {
+			_update_global(node_i);
+		}
+	}
+}
+
+void IKTransformStore3D::update_subtree_global_transforms(int32_t p_handle) const {
+	ERR_FAIL_INDEX(p_handle, (int32_t)local_transforms.size());
+	// Refresh the node itself first so the sweep below never reads a stale parent outside the range.
+	get_global_transform(p_handle);
+	for (int32_t node_i = p_handle + 1; node_i < subtree_ends[p_handle]; node_i++) {
+		if (!dirty[node_i]) {
+			continue;
+		}
+		global_transforms[node_i] = global_transforms[parents[node_i]] * local_transforms[node_i];
+		if (disable_scale[node_i]) {
+			global_transforms[node_i].basis.orthogonalize();
+		}
+		global_inverses[node_i] = global_transforms[node_i].affine_inverse();
+		dirty[node_i] = 0;
+	}
+}
+
+void IKTransformStore3D::set_transform(int32_t p_handle, const Transform3D &p_transform) {
+	ERR_FAIL_INDEX(p_handle, (int32_t)local_transforms.size());
+	if (local_transforms[p_handle] == p_transform) {
+		return;
+	}
+	local_transforms[p_handle] = p_transform;
+	_mark_dirty(p_handle);
+}
+
+const Transform3D &IKTransformStore3D::get_transform(int32_t p_handle) const {
+	CRASH_BAD_INDEX(p_handle, (int32_t)local_transforms.size());
+	return local_transforms[p_handle];
+}
+
+void IKTransformStore3D::set_global_transform(int32_t p_handle, const Transform3D &p_transform) {
+	ERR_FAIL_INDEX(p_handle, (int32_t)local_transforms.size());
+	int32_t parent = parents[p_handle];
+	local_transforms[p_handle] = parent != -1 ? get_global_inverse(parent) * p_transform : p_transform;
+	_mark_dirty(p_handle);
+}
+
+const Transform3D &IKTransformStore3D::get_global_transform(int32_t p_handle) const {
+	CRASH_BAD_INDEX(p_handle, (int32_t)global_transforms.size());
+	if (dirty[p_handle]) {
+		_update_global(p_handle);
+	}
+	return global_transforms[p_handle];
+}
+
+const Transform3D &IKTransformStore3D::get_global_inverse(int32_t p_handle) const {
+	// The inverse is refreshed together with the global, so a clean node is only ever read here.
+	get_global_transform(p_handle);
+	return global_inverses[p_handle];
+}
+
+void IKTransformStore3D::rotate_local_with_global(int32_t p_handle, const Basis &p_basis) {
+	ERR_FAIL_INDEX(p_handle, (int32_t)local_transforms.size());
+	int32_t parent = parents[p_handle];
+	if (parent == -1) {
+		return;
+	}
+	const Basis &new_rot = get_global_transform(parent).basis;
+	Basis &local_basis = local_transforms[p_handle].basis;
+	local_basis = get_global_inverse(parent).basis * p_basis * new_rot * local_basis;
+	_mark_dirty(p_handle);
+}
+
+void IKTransformStore3D::mark_dirty(int32_t p_handle) {
+	ERR_FAIL_INDEX(p_handle, (int32_t)local_transforms.size());
+	_mark_dirty(p_handle);
+}
+
+void IKTransformStore3D::set_disable_scale(int32_t p_handle, bool p_enabled) {
+	ERR_FAIL_INDEX(p_handle, (int32_t)disable_scale.size());
+	disable_scale[p_handle] = p_enabled;
+	_mark_dirty(p_handle);
+}
+
+bool IKTransformStore3D::is_scale_disabled(int32_t p_handle) const {
+	ERR_FAIL_INDEX_V(p_handle, (int32_t)disable_scale.size(), false);
+	return disable_scale[p_handle];
+}
+
+Vector3 IKTransformStore3D::to_local(int32_t p_handle, const Vector3 &p_global) const {
+	return get_global_inverse(p_handle).xform(p_global);
+}
+
+Vector3 IKTransformStore3D::to_global(int32_t p_handle, const Vector3 &p_local) const {
+	return get_global_transform(p_handle).xform(p_local);
+}
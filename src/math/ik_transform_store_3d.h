@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*  ik_transform_store_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef IK_TRANSFORM_STORE_3D_H
+#define IK_TRANSFORM_STORE_3D_H
+
+#include "core/math/transform_3d.h"
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+
+// Flat transform hierarchy used by the solver.
+// Nodes are appended in depth-first order, so every node's subtree is the
+// contiguous range [handle, subtree_end) and a parent always precedes its children.
+// Writes mark the subtree dirty; reads refresh globals with one forward sweep.
+class IKTransformStore3D : public RefCounted {
+	GDCLASS(IKTransformStore3D, RefCounted);
+
+	LocalVector<Transform3D> local_transforms;
+	mutable LocalVector<Transform3D> global_transforms;
+	LocalVector<int32_t> parents;
+	LocalVector<int32_t> subtree_ends;
+	mutable LocalVector<uint8_t> dirty;
+	// Affine inverses of the globals, recomputed in the same sweep that refreshes the global.
+	mutable LocalVector<Transform3D> global_inverses;
+	LocalVector<uint8_t> disable_scale;
+
+	void _mark_dirty(int32_t p_handle);
+	void _update_global(int32_t p_handle) const;
+
+public:
+	int32_t add_node(int32_t p_parent, const Transform3D &p_local = Transform3D());
+	int32_t size() const;
+	void clear();
+
+	int32_t get_parent(int32_t p_handle) const;
+	int32_t get_subtree_end(int32_t p_handle) const;
+
+	void set_transform(int32_t p_handle, const Transform3D &p_transform);
+	const Transform3D &get_transform(int32_t p_handle) const;
+	void set_global_transform(int32_t p_handle, const Transform3D &p_transform);
+	const Transform3D &get_global_transform(int32_t p_handle) const;
+	const Transform3D &get_global_inverse(int32_t p_handle) const;
+	void rotate_local_with_global(int32_t p_handle, const Basis &p_basis);
+	void mark_dirty(int32_t p_handle);
+	void update_global_transforms() const;
+	void update_subtree_global_transforms(int32_t p_handle) const;
+
+	void set_disable_scale(int32_t p_handle, bool p_enabled);
+	bool is_scale_disabled(int32_t p_handle) const;
+
+	Vector3 to_local(int32_t p_handle, const Vector3 &p_global) const;
+	Vector3 to_global(int32_t p_handle, const Vector3 &p_local) const;
+};
+
+#endif // IK_TRANSFORM_STORE_3D_H
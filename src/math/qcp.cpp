@@ -30,35 +30,88 @@
 
 #include "qcp.h"
 
-QuaternionCharacteristicPolynomial::QuaternionCharacteristicPolynomial(double p_evec_prec) {
-	eigenvector_precision = p_evec_prec;
+#include "ik_simd.h"
+
+template <typename T>
+void QCPSolver::_fill_headings(LocalVector<T> &r_headings, const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight) {
+	if (r_headings.size() < count * ROW_MAX) {
+		r_headings.resize(count * ROW_MAX);
+	}
+	T *row = r_headings.ptr();
+	for (uint32_t i = 0; i < count; i++) {
+		row[ROW_TARGET_X * count + i] = p_target[i].x;
+		row[ROW_TARGET_Y * count + i] = p_target[i].y;
+		row[ROW_TARGET_Z * count + i] = p_target[i].z;
+		row[ROW_MOVED_X * count + i] = p_moved[i].x;
+		row[ROW_MOVED_Y * count + i] = p_moved[i].y;
+		row[ROW_MOVED_Z * count + i] = p_moved[i].z;
+		row[ROW_WEIGHT * count + i] = p_weight ? p_weight[i] : 1.0;
+	}
 }
 
-void QuaternionCharacteristicPolynomial::set(PackedVector3Array &r_target, PackedVector3Array &r_moved) {
-	target = r_target;
-	moved = r_moved;
-	transformation_calculated = false;
-	inner_product_calculated = false;
+template <typename T>
+Vector3 QCPSolver::_move_to_weighted_center(T *p_headings, uint32_t p_row) {
+	// Centers the three rows starting at p_row in place and returns the center that was removed.
+	// The center itself is always found in double so the float path only loses precision in storage.
+	T *x = p_headings + p_row * count;
+	T *y = x + count;
+	T *z = y + count;
+	const T *w = p_headings + ROW_WEIGHT * count;
+	double center_x = 0, center_y = 0, center_z = 0, total_weight = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		center_x += double(x[i]) * w[i];
+		center_y += double(y[i]) * w[i];
+		center_z += double(z[i]) * w[i];
+		total_weight += w[i];
+	}
+	if (total_weight > 0) {
+		center_x /= total_weight;
+		center_y /= total_weight;
+		center_z /= total_weight;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		x[i] -= T(center_x);
+		y[i] -= T(center_y);
+		z[i] -= T(center_z);
+	}
+	return Vector3(center_x, center_y, center_z);
 }
 
-Quaternion QuaternionCharacteristicPolynomial::_get_rotation() {
-	Quaternion result;
-	if (!transformation_calculated) {
-		if (!inner_product_calculated) {
-			inner_product(target, moved);
+double QCPSolver::_get_heading(uint32_t p_row) const {
+	if (scalar_precision == SCALAR_PRECISION_FLOAT) {
+		return headings_single[p_row * count];
+	}
+	return headings[p_row * count];
+}
+
+void QCPSolver::weighted_superpose(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, uint32_t p_count, bool p_translate, Quaternion &r_rotation, Vector3 &r_translation) {
+	count = p_count;
+	r_translation = Vector3();
+	if (scalar_precision == SCALAR_PRECISION_FLOAT) {
+		_fill_headings(headings_single, p_moved, p_target, p_weight);
+		if (p_translate) {
+			Vector3 moved_center = _move_to_weighted_center(headings_single.ptr(), ROW_MOVED_X);
+			Vector3 target_center = _move_to_weighted_center(headings_single.ptr(), ROW_TARGET_X);
+			r_translation = target_center - moved_center;
+		}
+	} else {
+		_fill_headings(headings, p_moved, p_target, p_weight);
+		if (p_translate) {
+			Vector3 moved_center = _move_to_weighted_center(headings.ptr(), ROW_MOVED_X);
+			Vector3 target_center = _move_to_weighted_center(headings.ptr(), ROW_TARGET_X);
+			r_translation = target_center - moved_center;
 		}
-		result = calculate_rotation();
-		transformation_calculated = true;
 	}
-	return result;
+	inner_product();
+	r_rotation = calculate_rotation();
 }
 
-Quaternion QuaternionCharacteristicPolynomial::calculate_rotation() {
+Quaternion QCPSolver::calculate_rotation() const {
 	Quaternion result;
 
-	if (moved.size() == 1) {
-		Vector3 u = moved[0];
-		Vector3 v = target[0];
+	if (count == 1) {
+		Vector3 u = Vector3(_get_heading(ROW_MOVED_X), _get_heading(ROW_MOVED_Y), _get_heading(ROW_MOVED_Z));
+		Vector3 v = Vector3(_get_heading(ROW_TARGET_X), _get_heading(ROW_TARGET_Y), _get_heading(ROW_TARGET_Z));
 		double norm_product = u.length() * v.length();
 
 		if (norm_product == 0.0) {
@@ -126,83 +179,172 @@ Quaternion QuaternionCharacteristicPolynomial::calculate_rotation() {
 	return result;
 }
 
-void QuaternionCharacteristicPolynomial::translate(Vector3 r_translate, PackedVector3Array &r_x) {
-	for (Vector3 &p : r_x) {
-		p += r_translate;
+// Adds the headings from p_begin on to r_sums. Products are taken in T and summed in double.
+template <typename T>
+static void qcp_accumulate_sums_tail(const T *p_headings, uint32_t p_count, uint32_t p_begin, QCPHeadingSums &r_sums) {
+	// The target is the weighted set; the moved set is left as is.
+	const T *tx = p_headings + QCPSolver::ROW_TARGET_X * p_count;
+	const T *ty = p_headings + QCPSolver::ROW_TARGET_Y * p_count;
+	const T *tz = p_headings + QCPSolver::ROW_TARGET_Z * p_count;
+	const T *mx = p_headings + QCPSolver::ROW_MOVED_X * p_count;
+	const T *my = p_headings + QCPSolver::ROW_MOVED_Y * p_count;
+	const T *mz = p_headings + QCPSolver::ROW_MOVED_Z * p_count;
+	const T *w = p_headings + QCPSolver::ROW_WEIGHT * p_count;
+	for (uint32_t i = p_begin; i < p_count; i++) {
+		T wx = w[i] * tx[i];
+		T wy = w[i] * ty[i];
+		T wz = w[i] * tz[i];
+		r_sums.target_squares += wx * tx[i] + wy * ty[i] + wz * tz[i];
+		r_sums.moved_squares += w[i] * (mx[i] * mx[i] + my[i] * my[i] + mz[i] * mz[i]);
+		r_sums.xx += wx * mx[i];
+		r_sums.xy += wx * my[i];
+		r_sums.xz += wx * mz[i];
+		r_sums.yx += wy * mx[i];
+		r_sums.yy += wy * my[i];
+		r_sums.yz += wy * mz[i];
+		r_sums.zx += wz * mx[i];
+		r_sums.zy += wz * my[i];
+		r_sums.zz += wz * mz[i];
 	}
 }
 
-Vector3 QuaternionCharacteristicPolynomial::_get_translation() {
-	return target_center - moved_center;
+void QCPSolver::accumulate_sums_scalar(const double *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	r_sums = QCPHeadingSums();
+	qcp_accumulate_sums_tail(p_headings, p_count, 0, r_sums);
 }
 
-Vector3 QuaternionCharacteristicPolynomial::move_to_weighted_center(PackedVector3Array &r_to_center, Vector<double> &r_weight) {
-	Vector3 center;
-	double total_weight = 0;
-	bool weight_is_empty = r_weight.is_empty();
-	int size = r_to_center.size();
+void QCPSolver::accumulate_sums_scalar(const float *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	r_sums = QCPHeadingSums();
+	qcp_accumulate_sums_tail(p_headings, p_count, 0, r_sums);
+}
 
-	for (int i = 0; i < size; i++) {
-		if (!weight_is_empty) {
-			total_weight += r_weight[i];
-			center += r_to_center[i] * r_weight[i];
-		} else {
-			center += r_to_center[i];
-			total_weight++;
-		}
+#if defined(IK_SIMD_SSE2) || defined(IK_SIMD_NEON)
+
+template <typename T>
+struct QCPLanes;
+
+template <>
+struct QCPLanes<double> {
+	typedef ik_f64x2 Register;
+	static const uint32_t WIDTH = 2;
+};
+
+template <>
+struct QCPLanes<float> {
+	typedef ik_f32x4 Register;
+	static const uint32_t WIDTH = 4;
+};
+
+template <typename T>
+static void qcp_accumulate_sums(const T *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	typedef typename QCPLanes<T>::Register R;
+	const uint32_t width = QCPLanes<T>::WIDTH;
+	const T *tx = p_headings + QCPSolver::ROW_TARGET_X * p_count;
+	const T *ty = p_headings + QCPSolver::ROW_TARGET_Y * p_count;
+	const T *tz = p_headings + QCPSolver::ROW_TARGET_Z * p_count;
+	const T *mx = p_headings + QCPSolver::ROW_MOVED_X * p_count;
+	const T *my = p_headings + QCPSolver::ROW_MOVED_Y * p_count;
+	const T *mz = p_headings + QCPSolver::ROW_MOVED_Z * p_count;
+	const T *w = p_headings + QCPSolver::ROW_WEIGHT * p_count;
+
+	R xx = ik_zero(T()), xy = ik_zero(T()), xz = ik_zero(T());
+	R yx = ik_zero(T()), yy = ik_zero(T()), yz = ik_zero(T());
+	R zx = ik_zero(T()), zy = ik_zero(T()), zz = ik_zero(T());
+	R target_squares = ik_zero(T()), moved_squares = ik_zero(T());
+
+	uint32_t i = 0;
+	for (; i + width <= p_count; i += width) {
+		R weight = ik_load(w + i);
+		R target_x = ik_load(tx + i);
+		R target_y = ik_load(ty + i);
+		R target_z = ik_load(tz + i);
+		R moved_x = ik_load(mx + i);
+		R moved_y = ik_load(my + i);
+		R moved_z = ik_load(mz + i);
+		R weighted_x = ik_mul(weight, target_x);
+		R weighted_y = ik_mul(weight, target_y);
+		R weighted_z = ik_mul(weight, target_z);
+
+		target_squares = ik_madd(target_squares, weighted_x, target_x);
+		target_squares = ik_madd(target_squares, weighted_y, target_y);
+		target_squares = ik_madd(target_squares, weighted_z, target_z);
+		R moved_length_squared = ik_mul(moved_x, moved_x);
+		moved_length_squared = ik_madd(moved_length_squared, moved_y, moved_y);
+		moved_length_squared = ik_madd(moved_length_squared, moved_z, moved_z);
+		moved_squares = ik_madd(moved_squares, weight, moved_length_squared);
+
+		xx = ik_madd(xx, weighted_x, moved_x);
+		xy = ik_madd(xy, weighted_x, moved_y);
+		xz = ik_madd(xz, weighted_x, moved_z);
+		yx = ik_madd(yx, weighted_y, moved_x);
+		yy = ik_madd(yy, weighted_y, moved_y);
+		yz = ik_madd(yz, weighted_y, moved_z);
+		zx = ik_madd(zx, weighted_z, moved_x);
+		zy = ik_madd(zy, weighted_z, moved_y);
+		zz = ik_madd(zz, weighted_z, moved_z);
 	}
 
-	if (total_weight > 0) {
-		center /= total_weight;
-	}
+	r_sums.xx = ik_reduce(xx);
+	r_sums.xy = ik_reduce(xy);
+	r_sums.xz = ik_reduce(xz);
+	r_sums.yx = ik_reduce(yx);
+	r_sums.yy = ik_reduce(yy);
+	r_sums.yz = ik_reduce(yz);
+	r_sums.zx = ik_reduce(zx);
+	r_sums.zy = ik_reduce(zy);
+	r_sums.zz = ik_reduce(zz);
+	r_sums.target_squares = ik_reduce(target_squares);
+	r_sums.moved_squares = ik_reduce(moved_squares);
+
+	qcp_accumulate_sums_tail(p_headings, p_count, i, r_sums);
+}
 
-	return center;
+void QCPSolver::accumulate_sums(const double *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	qcp_accumulate_sums(p_headings, p_count, r_sums);
 }
 
-void QuaternionCharacteristicPolynomial::inner_product(PackedVector3Array &coords1, PackedVector3Array &coords2) {
-	Vector3 weighted_coord1, weighted_coord2;
-	double sum_of_squares1 = 0, sum_of_squares2 = 0;
-
-	sum_xx = 0;
-	sum_xy = 0;
-	sum_xz = 0;
-	sum_yx = 0;
-	sum_yy = 0;
-	sum_yz = 0;
-	sum_zx = 0;
-	sum_zy = 0;
-	sum_zz = 0;
-
-	bool weight_is_empty = weight.is_empty();
-	int size = coords1.size();
-
-	for (int i = 0; i < size; i++) {
-		if (!weight_is_empty) {
-			weighted_coord1 = weight[i] * coords1[i];
-			sum_of_squares1 += weighted_coord1.dot(coords1[i]);
-		} else {
-			weighted_coord1 = coords1[i];
-			sum_of_squares1 += weighted_coord1.dot(weighted_coord1);
-		}
+void QCPSolver::accumulate_sums(const float *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	qcp_accumulate_sums(p_headings, p_count, r_sums);
+}
 
-		weighted_coord2 = coords2[i];
+bool QCPSolver::has_simd() {
+	return true;
+}
 
-		sum_of_squares2 += weight_is_empty ? weighted_coord2.dot(weighted_coord2) : (weight[i] * weighted_coord2.dot(weighted_coord2));
+#else
 
-		sum_xx += (weighted_coord1.x * weighted_coord2.x);
-		sum_xy += (weighted_coord1.x * weighted_coord2.y);
-		sum_xz += (weighted_coord1.x * weighted_coord2.z);
+void QCPSolver::accumulate_sums(const double *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	accumulate_sums_scalar(p_headings, p_count, r_sums);
+}
 
-		sum_yx += (weighted_coord1.y * weighted_coord2.x);
-		sum_yy += (weighted_coord1.y * weighted_coord2.y);
-		sum_yz += (weighted_coord1.y * weighted_coord2.z);
+void QCPSolver::accumulate_sums(const float *p_headings, uint32_t p_count, QCPHeadingSums &r_sums) {
+	accumulate_sums_scalar(p_headings, p_count, r_sums);
+}
 
-		sum_zx += (weighted_coord1.z * weighted_coord2.x);
-		sum_zy += (weighted_coord1.z * weighted_coord2.y);
-		sum_zz += (weighted_coord1.z * weighted_coord2.z);
-	}
+bool QCPSolver::has_simd() {
+	return false;
+}
 
-	double initial_eigenvalue = (sum_of_squares1 + sum_of_squares2) * 0.5;
+#endif
+
+void QCPSolver::inner_product() {
+	QCPHeadingSums sums;
+	if (scalar_precision == SCALAR_PRECISION_FLOAT) {
+		accumulate_sums(headings_single.ptr(), count, sums);
+	} else {
+		accumulate_sums(headings.ptr(), count, sums);
+	}
+	sum_xx = sums.xx;
+	sum_xy = sums.xy;
+	sum_xz = sums.xz;
+	sum_yx = sums.yx;
+	sum_yy = sums.yy;
+	sum_yz = sums.yz;
+	sum_zx = sums.zx;
+	sum_zy = sums.zy;
+	sum_zz = sums.zz;
+
+	double initial_eigenvalue = (sums.target_squares + sums.moved_squares) * 0.5;
 
 	sum_xz_plus_zx = sum_xz + sum_zx;
 	sum_yz_plus_zy = sum_yz + sum_zy;
@@ -213,38 +355,6 @@ void QuaternionCharacteristicPolynomial::inner_product(PackedVector3Array &coord
 	sum_xx_plus_yy = sum_xx + sum_yy;
 	sum_xx_minus_yy = sum_xx - sum_yy;
 	max_eigenvalue = initial_eigenvalue;
-
-	inner_product_calculated = true;
-}
-
-Quaternion QuaternionCharacteristicPolynomial::_weighted_superpose(PackedVector3Array &p_moved, PackedVector3Array &p_target, Vector<double> &p_weight, bool translate) {
-	set(p_moved, p_target, p_weight, translate);
-	return _get_rotation();
-}
-
-void QuaternionCharacteristicPolynomial::set(PackedVector3Array &p_moved, PackedVector3Array &p_target, Vector<double> &p_weight, bool p_translate) {
-	transformation_calculated = false;
-	inner_product_calculated = false;
-
-	moved = p_moved;
-	target = p_target;
-	weight = p_weight;
-
-	if (p_translate) {
-		moved_center = move_to_weighted_center(moved, weight);
-		w_sum = 0; // set wsum to 0 so we don't double up.
-		target_center = move_to_weighted_center(target, weight);
-		translate(moved_center * -1, moved);
-		translate(target_center * -1, target);
-	} else {
-		if (!p_weight.is_empty()) {
-			for (int i = 0; i < p_weight.size(); i++) {
-				w_sum += p_weight[i];
-			}
-		} else {
-			w_sum = p_moved.size();
-		}
-	}
 }
 
 void QuaternionCharacteristicPolynomial::_bind_methods() {
@@ -258,11 +368,13 @@ Array QuaternionCharacteristicPolynomial::weighted_superpose(PackedVector3Array
 		PackedVector3Array p_target,
 		Vector<double> p_weight, bool p_translate,
 		double p_precision) {
-	QuaternionCharacteristicPolynomial qcp(p_precision);
-	Quaternion rotation =
-			qcp._weighted_superpose(p_moved, p_target, p_weight, p_translate);
-	Vector3 translation = qcp._get_translation();
 	Array result;
+	ERR_FAIL_COND_V(p_moved.size() != p_target.size(), result);
+	ERR_FAIL_COND_V(!p_weight.is_empty() && p_weight.size() != p_moved.size(), result);
+	QCPSolver qcp(p_precision);
+	Quaternion rotation;
+	Vector3 translation;
+	qcp.weighted_superpose(p_moved.ptr(), p_target.ptr(), p_weight.is_empty() ? nullptr : p_weight.ptr(), p_moved.size(), p_translate, rotation, translation);
 	result.push_back(rotation);
 	result.push_back(translation);
 	return result;
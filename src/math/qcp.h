@@ -31,9 +31,11 @@
 #ifndef QCP_H
 #define QCP_H
 
+#include "core/math/quaternion.h"
 #include "core/math/vector3.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 /**
@@ -44,7 +46,8 @@
  * 1. Create a QCP object with two Vector3 arrays of equal length as input.
  *    The input coordinates are not changed.
  * 2. Optionally, provide weighting factors [0 - 1] for each point.
- * 3. For maximum efficiency, create a QCP object once and reuse it.
+ * 3. For maximum efficiency, create a QCPSolver once and reuse it. The solver keeps
+ *    its scratch buffers between calls and reports results through out-parameters.
  *
  * A. Calculate rmsd only: double rmsd = qcp.getRmsd();
  * B. Calculate a 4x4 transformation (Quaternion and translation) matrix: Matrix4f trans = qcp.getTransformationMatrix();
@@ -68,32 +71,81 @@
  * @author K. S. Ernest (iFire) Lee (adapted to ManyBoneIK)
  */
 
-class QuaternionCharacteristicPolynomial : Object {
-	GDCLASS(QuaternionCharacteristicPolynomial, Object);
-	double eigenvector_precision = 1E-6;
+// Weighted cross and square sums over a set of headings, as consumed by the QCP eigen solve.
+struct QCPHeadingSums {
+	double xx = 0, xy = 0, xz = 0;
+	double yx = 0, yy = 0, yz = 0;
+	double zx = 0, zy = 0, zz = 0;
+	double target_squares = 0, moved_squares = 0;
+};
 
-	PackedVector3Array target, moved;
-	Vector<double> weight;
-	double w_sum = 0;
+class QCPSolver {
+public:
+	enum ScalarPrecision {
+		SCALAR_PRECISION_DOUBLE, // Headings and sums in double; two lanes per SIMD register.
+		SCALAR_PRECISION_FLOAT, // Headings and per-lane sums in float; four lanes per SIMD register.
+	};
 
-	Vector3 target_center, moved_center;
+private:
+	double eigenvector_precision = 1E-6;
+	ScalarPrecision scalar_precision = SCALAR_PRECISION_DOUBLE;
+
+	// Headings are stored as structure-of-arrays rows of `count` scalars so the sums can be vectorized.
+	// Only the buffer matching scalar_precision is filled.
+	LocalVector<double> headings;
+	LocalVector<float> headings_single;
+	uint32_t count = 0;
 
 	double sum_xy = 0, sum_xz = 0, sum_yx = 0, sum_yz = 0, sum_zx = 0, sum_zy = 0;
 	double sum_xx_plus_yy = 0, sum_zz = 0, max_eigenvalue = 0, sum_yz_minus_zy = 0, sum_xz_minus_zx = 0, sum_xy_minus_yx = 0;
 	double sum_xx_minus_yy = 0, sum_xy_plus_yx = 0, sum_xz_plus_zx = 0;
 	double sum_yy = 0, sum_xx = 0, sum_yz_plus_zy = 0;
-	bool transformation_calculated = false, inner_product_calculated = false;
-
-	void inner_product(PackedVector3Array &coords1, PackedVector3Array &coords2);
-	void set(PackedVector3Array &r_target, PackedVector3Array &r_moved);
-	Quaternion calculate_rotation();
-	void set(PackedVector3Array &p_moved, PackedVector3Array &p_target, Vector<double> &p_weight, bool p_translate);
-	static void translate(Vector3 r_translate, PackedVector3Array &r_x);
-	Vector3 move_to_weighted_center(PackedVector3Array &r_to_center, Vector<double> &r_weight);
-	QuaternionCharacteristicPolynomial(double p_evec_prec);
-	Quaternion _weighted_superpose(PackedVector3Array &p_moved, PackedVector3Array &p_target, Vector<double> &p_weight, bool translate);
-	Quaternion _get_rotation();
-	Vector3 _get_translation();
+
+	template <typename T>
+	void _fill_headings(LocalVector<T> &r_headings, const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight);
+	template <typename T>
+	Vector3 _move_to_weighted_center(T *p_headings, uint32_t p_row);
+	double _get_heading(uint32_t p_row) const;
+	void inner_product();
+	Quaternion calculate_rotation() const;
+
+public:
+	enum HeadingRow {
+		ROW_TARGET_X,
+		ROW_TARGET_Y,
+		ROW_TARGET_Z,
+		ROW_MOVED_X,
+		ROW_MOVED_Y,
+		ROW_MOVED_Z,
+		ROW_WEIGHT,
+		ROW_MAX,
+	};
+
+	void set_precision(double p_precision) { eigenvector_precision = p_precision; }
+	double get_precision() const { return eigenvector_precision; }
+	// The eigen solve always runs in double; this only selects the storage and the accumulation of the heading sums.
+	void set_scalar_precision(ScalarPrecision p_precision) { scalar_precision = p_precision; }
+	ScalarPrecision get_scalar_precision() const { return scalar_precision; }
+
+	// Superposes p_moved onto p_target. p_weight may be null for uniform weights.
+	// Scratch storage is kept between calls so a reused solver does not allocate once warmed up.
+	void weighted_superpose(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, uint32_t p_count, bool p_translate, Quaternion &r_rotation, Vector3 &r_translation);
+
+	// p_headings holds ROW_MAX rows of p_count doubles each, laid out as HeadingRow.
+	static void accumulate_sums_scalar(const double *p_headings, uint32_t p_count, QCPHeadingSums &r_sums);
+	static void accumulate_sums_scalar(const float *p_headings, uint32_t p_count, QCPHeadingSums &r_sums);
+	// Uses SSE2 or NEON when the target supports it and falls back to accumulate_sums_scalar() otherwise.
+	// The float overload accumulates in float, so it processes twice as many headings per instruction.
+	static void accumulate_sums(const double *p_headings, uint32_t p_count, QCPHeadingSums &r_sums);
+	static void accumulate_sums(const float *p_headings, uint32_t p_count, QCPHeadingSums &r_sums);
+	static bool has_simd();
+
+	QCPSolver() {}
+	QCPSolver(double p_precision) { eigenvector_precision = p_precision; }
+};
+
+class QuaternionCharacteristicPolynomial : Object {
+	GDCLASS(QuaternionCharacteristicPolynomial, Object);
 
 protected:
 	static void _bind_methods();
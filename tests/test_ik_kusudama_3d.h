@@ -30,6 +30,7 @@
 
 #ifndef TEST_IK_KUSUDAMA_3D_H
 #define TEST_IK_KUSUDAMA_3D_H
+#include "modules/many_bone_ik/src/ik_constraint_batch_3d.h"
 #include "modules/many_bone_ik/src/ik_kusudama_3d.h"
 #include "tests/test_macros.h"
 
@@ -291,6 +292,461 @@ TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Check limit cones clear functiona
 	open_cones = kusudama->get_open_cones();
 	CHECK(open_cones.size() == 0); // Expect no limit cones to remain
 }
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Compiled cones match the per-cone limit checks") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+
+	const Vector3 control_points[] = { Vector3(1, 0.2, 0.1), Vector3(0, 1, 0.3), Vector3(-0.5, 0.2, 1) };
+	const real_t radii[] = { 0.4, 0.3, 0.5 };
+	for (int32_t i = 0; i < 3; i++) {
+		Ref<IKLimitCone3D> cone;
+		cone.instantiate();
+		cone->set_attached_to(kusudama);
+		cone->set_radius(radii[i]);
+		cone->set_control_point(control_points[i].normalized());
+		kusudama->add_open_cone(cone);
+	}
+	TypedArray<IKLimitCone3D> open_cones = kusudama->get_open_cones();
+	REQUIRE(open_cones.size() == 3);
+
+	Vector<double> bounds;
+	bounds.resize(2);
+	const int32_t sample_count = 512;
+	for (int32_t sample_i = 0; sample_i < sample_count; sample_i++) {
+		// Spread the samples over the sphere on a Fibonacci lattice.
+		real_t y = 1.0 - (sample_i + 0.5) * 2.0 / sample_count;
+		real_t ring = Math::sqrt(1.0 - y * y);
+		real_t longitude = sample_i * Math_PI * (3.0 - Math::sqrt(5.0));
+		Vector3 point = Vector3(Math::cos(longitude) * ring, y, Math::sin(longitude) * ring);
+
+		bool expected_in_bounds = false;
+		Vector3 expected = point;
+		real_t closest_cos = -2.0;
+		for (int32_t cone_i = 0; cone_i < open_cones.size() && !expected_in_bounds; cone_i++) {
+			Ref<IKLimitCone3D> cone = open_cones[cone_i];
+			Vector3 collision_point = cone->closest_to_cone(point, nullptr);
+			if (Math::is_nan(collision_point.x)) {
+				expected_in_bounds = true;
+			} else if (collision_point.dot(point) > closest_cos) {
+				expected = collision_point;
+				closest_cos = collision_point.dot(point);
+			}
+		}
+		for (int32_t cone_i = 0; cone_i < open_cones.size() - 1 && !expected_in_bounds; cone_i++) {
+			Ref<IKLimitCone3D> cone = open_cones[cone_i];
+			Vector3 collision_point = cone->get_on_great_tangent_triangle(open_cones[cone_i + 1], point);
+			if (Math::is_nan(collision_point.x)) {
+				continue;
+			}
+			if (Math::is_equal_approx(collision_point.dot(point), real_t(1.0))) {
+				expected_in_bounds = true;
+			} else if (collision_point.dot(point) > closest_cos) {
+				expected = collision_point;
+				closest_cos = collision_point.dot(point);
+			}
+		}
+
+		Vector3 returned = kusudama->get_local_point_in_limits(point, &bounds);
+		CHECK_EQ(bounds[0] > 0, expected_in_bounds);
+		if (expected_in_bounds) {
+			CHECK(returned.is_equal_approx(point));
+		} else {
+			CHECK(returned.distance_to(expected) < 1e-4);
+		}
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Editing an added cone updates the limits") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+
+	Ref<IKLimitCone3D> cone;
+	cone.instantiate();
+	cone->set_attached_to(kusudama);
+	cone->set_radius(0.3);
+	cone->set_control_point(Vector3(0, 0, 1));
+	kusudama->add_open_cone(cone);
+
+	Vector<double> bounds;
+	bounds.resize(2);
+	Vector3 test_point = Vector3(0, 0, 1).rotated(Vector3(0, 1, 0), 0.6);
+	kusudama->get_local_point_in_limits(test_point, &bounds);
+	CHECK_EQ(bounds[0], -1);
+
+	cone->set_radius(0.8);
+	Vector3 returned_point = kusudama->get_local_point_in_limits(test_point, &bounds);
+	CHECK_EQ(bounds[0], 1);
+	CHECK(returned_point.is_equal_approx(test_point));
+}
+
+// Reference for apply_limits(): snaps the swing back to the nearest point in the limits, as the solver used to before
+// the limits were fused.
+static void _snap_to_orientation_limit(const Ref<IKKusudama3D> &p_kusudama, IKTransformStore3D *p_store, int32_t p_bone_direction, int32_t p_to_set, int32_t p_limiting_axes) {
+	const Transform3D &limiting_global = p_store->get_global_transform(p_limiting_axes);
+	Vector3 bone_tip_global = p_store->get_global_transform(p_bone_direction).xform(Vector3(0, 1, 0));
+	Vector3 bone_tip = p_store->get_global_inverse(p_limiting_axes).xform(bone_tip_global);
+	double in_bounds = 1.0;
+	Vector3 in_limits = p_kusudama->get_local_point_in_limits(bone_tip, in_bounds);
+	if (in_bounds >= 0) {
+		return;
+	}
+	Vector3 bone_heading = (bone_tip_global - limiting_global.origin).normalized();
+	Vector3 constrained_heading = (limiting_global.xform(in_limits) - limiting_global.origin).normalized();
+	p_store->rotate_local_with_global(p_to_set, Quaternion(bone_heading, constrained_heading));
+}
+
+// Reference for apply_limits(): clamps the twist from a fresh swing-twist decomposition of the snapped bone.
+static void _snap_to_twist_limit(const Ref<IKKusudama3D> &p_kusudama, IKTransformStore3D *p_store, int32_t p_to_set, int32_t p_twist_axes) {
+	if (!p_kusudama->is_axially_constrained()) {
+		return;
+	}
+	IKConstraintFrames3D frames;
+	p_kusudama->compute_constraint_frames(Transform3D(), p_store->get_global_transform(p_twist_axes), frames);
+	Basis global_twist_center = Basis(frames.twist_center);
+	Basis align_rot = (global_twist_center.inverse() * p_store->get_global_transform(p_to_set).basis).orthonormalized();
+	Quaternion swing_rotation, twist_rotation;
+	IKKusudama3D::get_swing_twist(align_rot.get_rotation_quaternion(), Vector3(0, 1, 0), swing_rotation, twist_rotation);
+	twist_rotation = IKBoneSegment3D::clamp_to_cos_half_angle(twist_rotation, Math::cos(p_kusudama->get_range_angle() / 4.0));
+	Basis recomposition = (global_twist_center * (swing_rotation * twist_rotation)).orthonormalized();
+	Basis rotation = p_store->get_global_inverse(p_store->get_parent(p_to_set)).basis * recomposition;
+	p_store->set_transform(p_to_set, Transform3D(rotation, p_store->get_transform(p_to_set).origin));
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Fused limits match the general snaps") {
+	const Vector3 control_points[] = { Vector3(0, 1, 0), Vector3(1, 1, 0) };
+	const real_t radii[] = { 0.5, 0.3 };
+	const Basis poses[] = {
+		Basis(Vector3(1, 0, 0.3).normalized(), 1.2),
+		Basis(Vector3(0, 1, 0), 1.0),
+		Basis(Vector3(0.2, 0.4, -1).normalized(), 0.2),
+		Basis(Vector3(0, 0, 1), -2.0),
+	};
+
+	// One kusudama takes the single cone path, the other searches two cones and the path between them.
+	for (int32_t cone_count = 1; cone_count <= 2; cone_count++) {
+		Ref<IKKusudama3D> kusudama;
+		kusudama.instantiate();
+		for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+			Ref<IKLimitCone3D> cone;
+			cone.instantiate();
+			cone->set_attached_to(kusudama);
+			cone->set_radius(radii[cone_i]);
+			cone->set_control_point(control_points[cone_i].normalized());
+			kusudama->add_open_cone(cone);
+		}
+		kusudama->set_axial_limits(-0.3, 0.6);
+		kusudama->enable();
+		CHECK_EQ(kusudama->is_single_cone(), cone_count == 1);
+
+		for (const Basis &pose : poses) {
+			Ref<IKTransformStore3D> stores[2];
+			int32_t orientation = -1, twist = -1, bone = -1, direction = -1;
+			for (Ref<IKTransformStore3D> &store : stores) {
+				store.instantiate();
+				int32_t parent = store->add_node(-1, Transform3D(Basis(Vector3(0, 0, 1), 0.4), Vector3(1, 2, 3)));
+				orientation = store->add_node(parent);
+				twist = store->add_node(parent);
+				bone = store->add_node(parent, Transform3D(pose, Vector3()));
+				direction = store->add_node(bone);
+			}
+
+			_snap_to_orientation_limit(kusudama, stores[0].ptr(), direction, bone, orientation);
+			_snap_to_twist_limit(kusudama, stores[0].ptr(), bone, twist);
+			kusudama->apply_limits(stores[1].ptr(), direction, bone, orientation, twist);
+
+			Quaternion general = stores[0]->get_transform(bone).basis.get_rotation_quaternion();
+			Quaternion fused = stores[1]->get_transform(bone).basis.get_rotation_quaternion();
+			CHECK(general.angle_to(fused) < 1e-3);
+		}
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Scaled limiting axes snap several cones like unscaled ones") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	const Vector3 control_points[] = { Vector3(0, 1, 0), Vector3(1, 1, 0) };
+	for (const Vector3 &control_point : control_points) {
+		Ref<IKLimitCone3D> cone;
+		cone.instantiate();
+		cone->set_radius(0.3);
+		cone->set_control_point(control_point.normalized());
+		cone->set_attached_to(kusudama);
+		kusudama->add_open_cone(cone);
+	}
+	kusudama->enable_orientational_limits();
+	REQUIRE_FALSE(kusudama->is_single_cone());
+
+	// Only the scale of the limiting axes differs, so both bones must end up with the same rotation.
+	const real_t scales[] = { 1.0, 2.0 };
+	Quaternion snapped[2];
+	for (int32_t store_i = 0; store_i < 2; store_i++) {
+		Ref<IKTransformStore3D> store;
+		store.instantiate();
+		int32_t parent = store->add_node(-1, Transform3D(Basis(Vector3(0, 0, 1), 0.4), Vector3(1, 2, 3)));
+		int32_t orientation = store->add_node(parent, Transform3D(Basis().scaled(Vector3(1, 1, 1) * scales[store_i]), Vector3()));
+		int32_t twist = store->add_node(parent);
+		int32_t bone = store->add_node(parent, Transform3D(Basis(Vector3(0, 0, 1), -2.0), Vector3()));
+		int32_t direction = store->add_node(bone);
+		CHECK(kusudama->apply_limits(store.ptr(), direction, bone, orientation, twist) > 0);
+		snapped[store_i] = store->get_transform(bone).basis.get_rotation_quaternion();
+	}
+	CHECK(snapped[0].angle_to(snapped[1]) < 1e-3);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Cached constraint frames match the transform store") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	Ref<IKLimitCone3D> cone;
+	cone.instantiate();
+	cone->set_attached_to(kusudama);
+	cone->set_radius(0.4);
+	cone->set_control_point(Vector3(0, 1, 0));
+	kusudama->add_open_cone(cone);
+	kusudama->set_axial_limits(-0.3, 0.6);
+	kusudama->enable();
+
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+	int32_t parent = store->add_node(-1, Transform3D(Basis(Vector3(0, 0, 1), 0.4), Vector3(1, 2, 3)));
+	int32_t orientation = store->add_node(parent, Transform3D(Basis(Vector3(1, 0, 0), 0.3), Vector3()));
+	int32_t twist = store->add_node(parent, Transform3D(Basis(Vector3(0, 1, 0), -0.7), Vector3()));
+	int32_t bone = store->add_node(parent, Transform3D(Basis(Vector3(1, 0, 0.3).normalized(), 1.2), Vector3()));
+	int32_t direction = store->add_node(bone);
+
+	IKConstraintFrames3D frames;
+	kusudama->compute_constraint_frames(store.ptr(), bone, orientation, twist, frames);
+	CHECK(frames.limiting.is_equal_approx(store->get_global_transform(orientation)));
+	CHECK(frames.limiting_inverse.is_equal_approx(store->get_global_inverse(orientation).basis));
+	CHECK(frames.parent_inverse.is_equal_approx(store->get_global_inverse(parent).basis));
+
+	// The frames only depend on the parent, so they stay valid after the bone itself is snapped.
+	CHECK(kusudama->apply_limits(store.ptr(), direction, bone, frames) > 0);
+	Quaternion snapped = store->get_transform(bone).basis.get_rotation_quaternion();
+	kusudama->apply_limits(store.ptr(), direction, bone, frames);
+	CHECK(snapped.angle_to(store->get_transform(bone).basis.get_rotation_quaternion()) < 1e-3);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Constraint frames read the parent inverse refreshed by the sweep") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	kusudama->set_axial_limits(-0.3, 0.6);
+	kusudama->enable();
+
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+	int32_t root = store->add_node(-1, Transform3D(Basis(Vector3(0, 0, 1), 0.4), Vector3(1, 2, 3)));
+	int32_t parent = store->add_node(root, Transform3D(Basis(Vector3(1, 0, 0), 0.2), Vector3(0, 1, 0)));
+	int32_t bone = store->add_node(parent);
+	store->update_global_transforms();
+
+	// Moving the parent and sweeping the subtree must leave its inverse up to date without a lazy refresh.
+	store->set_transform(parent, Transform3D(Basis(Vector3(0, 1, 0), -0.9), Vector3(0, 2, 0)));
+	store->update_subtree_global_transforms(root);
+	IKConstraintFrames3D frames;
+	kusudama->compute_constraint_frames(store.ptr(), bone, parent, parent, frames);
+	CHECK(frames.parent_inverse.is_equal_approx(store->get_global_transform(parent).affine_inverse().basis));
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Resistance pulls toward the arc between cones") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	const Vector3 control_points[] = { Vector3(0, 1, 0), Vector3(1, 1, 0) };
+	for (const Vector3 &control_point : control_points) {
+		Ref<IKLimitCone3D> cone;
+		cone.instantiate();
+		cone->set_attached_to(kusudama);
+		cone->set_radius(0.5);
+		cone->set_control_point(control_point.normalized());
+		kusudama->add_open_cone(cone);
+	}
+	kusudama->enable_orientational_limits();
+	kusudama->disable_axial_limits();
+
+	const Vector3 heading = Vector3(0.3, 1, 0.4).normalized();
+	const Vector3 comfort = Vector3(0.3, 1, 0).normalized();
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+	int32_t parent = store->add_node(-1);
+	int32_t orientation = store->add_node(parent);
+	int32_t twist = store->add_node(parent);
+	int32_t bone = store->add_node(parent, Transform3D(Basis(Quaternion(Vector3(0, 1, 0), heading)), Vector3()));
+	int32_t direction = store->add_node(bone);
+	IKConstraintFrames3D frames;
+	kusudama->compute_constraint_frames(store.ptr(), bone, orientation, twist, frames);
+
+	CHECK_EQ(kusudama->apply_resistance(store.ptr(), direction, bone, frames, 0.0, 1.0), 0);
+
+	// A partial pull moves the heading by exactly the allowed angle.
+	const double angle = heading.angle_to(comfort) * 0.5;
+	CHECK_EQ(kusudama->apply_resistance(store.ptr(), direction, bone, frames, angle, Math::cos(angle / 2.0)), 1);
+	Vector3 pulled = store->get_global_transform(direction).basis.get_column(Vector3::AXIS_Y).normalized();
+	CHECK(Math::abs(pulled.angle_to(heading) - angle) < 1e-3);
+	CHECK(Math::abs(pulled.angle_to(comfort) - angle) < 1e-3);
+
+	// An unbounded pull lands on the arc joining the control points.
+	kusudama->apply_resistance(store.ptr(), direction, bone, frames, Math_PI, 0.0);
+	pulled = store->get_global_transform(direction).basis.get_column(Vector3::AXIS_Y).normalized();
+	CHECK(pulled.angle_to(comfort) < 1e-3);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Constraint batch matches the per-bone limits") {
+	// A single cone, two cones, and a twist-only constraint, repeated so the lanes cover both the paired and the tail path.
+	const int32_t kind_count = 3;
+	Ref<IKKusudama3D> kusudamas[kind_count];
+	const Vector3 control_points[] = { Vector3(0, 1, 0), Vector3(1, 1, 0) };
+	for (int32_t kind_i = 0; kind_i < kind_count; kind_i++) {
+		Ref<IKKusudama3D> &kusudama = kusudamas[kind_i];
+		kusudama.instantiate();
+		kusudama->set_axial_limits(-0.3, 0.6);
+		kusudama->enable_axial_limits();
+		if (kind_i == 2) {
+			kusudama->disable_orientational_limits();
+			continue;
+		}
+		for (int32_t cone_i = 0; cone_i <= kind_i; cone_i++) {
+			Ref<IKLimitCone3D> cone;
+			cone.instantiate();
+			cone->set_attached_to(kusudama);
+			cone->set_radius(0.4);
+			cone->set_control_point(control_points[cone_i].normalized());
+			kusudama->add_open_cone(cone);
+		}
+		kusudama->enable_orientational_limits();
+	}
+
+	IKConstraintBatch3D batch;
+	const int32_t lane_count = 7 * kind_count;
+	for (int32_t lane = 0; lane < lane_count; lane++) {
+		batch.add_lane(lane, kusudamas[lane % kind_count].ptr());
+	}
+	REQUIRE_EQ(batch.size(), uint32_t(lane_count));
+	for (int32_t lane = 0; lane < lane_count; lane++) {
+		real_t t = lane * 0.618;
+		batch.direction_x[lane] = Math::cos(t);
+		batch.direction_y[lane] = Math::sin(t * 0.37) + 0.5;
+		batch.direction_z[lane] = Math::sin(t);
+		batch.twist[lane] = Math::sin(t * 1.7) * 0.6;
+	}
+	IKConstraintBatch3D clamped = batch;
+	batch.evaluate(false);
+	clamped.evaluate(true);
+
+	for (int32_t lane = 0; lane < lane_count; lane++) {
+		Ref<IKKusudama3D> &kusudama = kusudamas[lane % kind_count];
+		Vector3 direction = Vector3(batch.direction_x[lane], batch.direction_y[lane], batch.direction_z[lane]);
+		double expected_in_bounds = 1.0;
+		Vector3 expected = direction;
+		if (kusudama->is_orientationally_constrained()) {
+			expected = kusudama->get_local_point_in_limits(direction, expected_in_bounds);
+		}
+		CHECK_EQ(batch.in_bounds[lane], expected_in_bounds < 0.0 ? -1.0 : 1.0);
+		CHECK_EQ(batch.twist_in_bounds[lane], Math::abs(batch.twist[lane]) <= 0.3 ? 1.0 : -1.0);
+		if (expected_in_bounds < 0.0) {
+			CHECK(Vector3(clamped.direction_x[lane], clamped.direction_y[lane], clamped.direction_z[lane]).is_equal_approx(expected));
+		}
+		CHECK(Math::abs(clamped.twist[lane]) <= 0.3 + CMP_EPSILON);
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Limit violation measures the angles outside the limits") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	Ref<IKLimitCone3D> cone;
+	cone.instantiate();
+	cone->set_attached_to(kusudama);
+	cone->set_radius(0.4);
+	cone->set_control_point(Vector3(0, 1, 0));
+	kusudama->add_open_cone(cone);
+	kusudama->set_axial_limits(-0.3, 0.6);
+	kusudama->enable();
+
+	IKConstraintFrames3D frames;
+	kusudama->compute_constraint_frames(Transform3D(), Transform3D(), frames);
+	real_t swing = -1, twist = -1;
+
+	Basis twist_center = Basis(frames.twist_center);
+	kusudama->get_limit_violation(frames, twist_center, Vector3(0, 1, 0), swing, twist);
+	CHECK(Math::is_zero_approx(swing));
+	CHECK(Math::is_zero_approx(twist));
+
+	Basis swung = Basis(Vector3(1, 0, 0), 0.7) * twist_center;
+	kusudama->get_limit_violation(frames, swung, swung.xform(Vector3(0, 1, 0)), swing, twist);
+	CHECK(Math::abs(swing - 0.3) < 1e-3);
+	CHECK(Math::is_zero_approx(twist));
+
+	Basis twisted = twist_center * Basis(Vector3(0, 1, 0), 0.5);
+	kusudama->get_limit_violation(frames, twisted, twisted.xform(Vector3(0, 1, 0)), swing, twist);
+	CHECK(Math::is_zero_approx(swing));
+	CHECK(Math::abs(twist - 0.2) < 1e-3);
+
+	// Widening the cone is picked up right away, through the const query path.
+	cone->set_radius(0.8);
+	const IKKusudama3D *widened = kusudama.ptr();
+	widened->get_limit_violation(frames, swung, swung.xform(Vector3(0, 1, 0)), swing, twist);
+	CHECK(Math::is_zero_approx(swing));
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Single cone flag follows the open cones") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	CHECK_FALSE(kusudama->is_single_cone());
+	Ref<IKLimitCone3D> cones[2];
+	for (Ref<IKLimitCone3D> &cone : cones) {
+		cone.instantiate();
+		cone->set_radius(0.4);
+		cone->set_attached_to(kusudama);
+	}
+	cones[1]->set_control_point(Vector3(1, 0, 0));
+	kusudama->add_open_cone(cones[0]);
+	CHECK(kusudama->is_single_cone());
+	kusudama->add_open_cone(cones[1]);
+	CHECK_FALSE(kusudama->is_single_cone());
+	kusudama->remove_open_cone(cones[1]);
+	CHECK(kusudama->is_single_cone());
+	// Editing the remaining cone recompiles it without changing the branch.
+	cones[0]->set_radius(0.6);
+	CHECK(kusudama->is_single_cone());
+	kusudama->clear_open_cones();
+	CHECK_FALSE(kusudama->is_single_cone());
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Bounds grid does not change the limits") {
+	const Vector3 control_points[] = { Vector3(1, 0.2, 0.1), Vector3(0, 1, 0.3), Vector3(-0.5, 0.2, 1), Vector3(0, -1, 0) };
+	const real_t radii[] = { 0.6, 0.3, 0.9, 0.4 };
+	Ref<IKKusudama3D> kusudamas[2];
+	for (Ref<IKKusudama3D> &kusudama : kusudamas) {
+		kusudama.instantiate();
+		for (int32_t i = 0; i < 4; i++) {
+			Ref<IKLimitCone3D> cone;
+			cone.instantiate();
+			cone->set_attached_to(kusudama);
+			cone->set_radius(radii[i]);
+			cone->set_control_point(control_points[i].normalized());
+			kusudama->add_open_cone(cone);
+		}
+	}
+	CHECK_EQ(kusudamas[0]->get_bounds_grid_memory_usage(), 0);
+	kusudamas[1]->set_bounds_grid_resolution(31);
+	CHECK_EQ(kusudamas[1]->get_bounds_grid_resolution(), 32);
+
+	Vector<double> bounds;
+	bounds.resize(2);
+	const int32_t sample_count = 2048;
+	for (int32_t sample_i = 0; sample_i < sample_count; sample_i++) {
+		real_t y = 1.0 - (sample_i + 0.5) * 2.0 / sample_count;
+		real_t ring = Math::sqrt(1.0 - y * y);
+		real_t longitude = sample_i * Math_PI * (3.0 - Math::sqrt(5.0));
+		Vector3 point = Vector3(Math::cos(longitude) * ring, y, Math::sin(longitude) * ring);
+
+		Vector3 exact = kusudamas[0]->get_local_point_in_limits(point, &bounds);
+		double exact_bounds = bounds[0];
+		Vector3 gridded = kusudamas[1]->get_local_point_in_limits(point, &bounds);
+		CHECK_EQ(bounds[0], exact_bounds);
+		CHECK(gridded.is_equal_approx(exact));
+	}
+	CHECK_EQ(kusudamas[1]->get_bounds_grid_memory_usage(), int64_t(32 * 32 / 8));
+}
 } // namespace TestIKKusudama3D
 
 #endif // TEST_IK_KUSUDAMA_3D_H
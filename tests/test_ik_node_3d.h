@@ -104,6 +104,94 @@ TEST_CASE("[Modules][IKNode3D] Test local transform calculation") {
 
 	CHECK(node->get_transform() == expected_local_transform);
 }
+
+TEST_CASE("[Modules][IKNode3D] Transform store hierarchy") {
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+
+	int32_t root = store->add_node(-1);
+	int32_t child = store->add_node(root);
+	int32_t grandchild = store->add_node(child);
+	int32_t sibling = store->add_node(root);
+	CHECK(store->get_subtree_end(root) == 4);
+	CHECK(store->get_subtree_end(child) == 3);
+	CHECK(store->get_subtree_end(sibling) == 4);
+
+	// The child's subtree is closed once a sibling was appended after it.
+	ERR_PRINT_OFF;
+	CHECK(store->add_node(child) == -1);
+	ERR_PRINT_ON;
+
+	Transform3D offset;
+	offset.origin = Vector3(1, 0, 0);
+	store->set_transform(root, offset);
+	store->set_transform(child, offset);
+	store->set_transform(grandchild, offset);
+	CHECK(store->get_global_transform(grandchild).origin.is_equal_approx(Vector3(3, 0, 0)));
+	CHECK(store->get_global_transform(sibling).origin.is_equal_approx(Vector3(1, 0, 0)));
+
+	store->set_global_transform(child, Transform3D());
+	CHECK(store->get_transform(child).origin.is_equal_approx(Vector3(-1, 0, 0)));
+	CHECK(store->get_global_transform(grandchild).origin.is_equal_approx(Vector3(1, 0, 0)));
+
+	Basis quarter_turn = Basis(Vector3(0, 1, 0), Math_PI / 2.0);
+	store->rotate_local_with_global(child, quarter_turn);
+	CHECK(store->get_global_transform(grandchild).origin.is_equal_approx(quarter_turn.xform(Vector3(1, 0, 0))));
+}
+
+TEST_CASE("[Modules][IKNode3D] Nodes bound to a transform store") {
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+	Ref<IKNode3D> parent;
+	parent.instantiate();
+	Ref<IKNode3D> node;
+	node.instantiate();
+
+	Transform3D local;
+	local.origin = Vector3(0, 2, 0);
+	node->set_transform(local);
+	parent->bind_to_store(store, store->add_node(-1));
+	node->bind_to_store(store, store->add_node(parent->get_handle()));
+	CHECK(node->is_bound_to_store());
+	CHECK(node->get_transform() == local);
+
+	Transform3D parent_transform;
+	parent_transform.origin = Vector3(4, 5, 6);
+	parent->set_transform(parent_transform);
+	CHECK(node->get_global_transform().origin.is_equal_approx(Vector3(4, 7, 6)));
+	CHECK(store->get_global_transform(node->get_handle()) == node->get_global_transform());
+
+	node->unbind_from_store();
+	CHECK_FALSE(node->is_bound_to_store());
+	CHECK(node->get_transform() == local);
+}
+
+TEST_CASE("[Modules][IKNode3D] Unbound children follow a node bound to a transform store") {
+	Ref<IKTransformStore3D> store;
+	store.instantiate();
+	Ref<IKNode3D> parent;
+	parent.instantiate();
+	parent->bind_to_store(store, store->add_node(-1));
+	Ref<IKNode3D> helper;
+	helper.instantiate();
+	helper->set_parent(parent);
+	Transform3D local;
+	local.origin = Vector3(0, 1, 0);
+	helper->set_transform(local);
+	CHECK(helper->get_global_transform().origin.is_equal_approx(Vector3(0, 1, 0)));
+
+	Transform3D parent_transform;
+	parent_transform.origin = Vector3(2, 0, 0);
+	parent->set_transform(parent_transform);
+	CHECK(helper->get_global_transform().origin.is_equal_approx(Vector3(2, 1, 0)));
+
+	parent->set_global_transform(Transform3D(Basis(), Vector3(0, 0, 3)));
+	CHECK(helper->get_global_transform().origin.is_equal_approx(Vector3(0, 1, 3)));
+
+	Basis half_turn = Basis(Vector3(0, 0, 1), Math_PI);
+	parent->rotate_local_with_global(half_turn, true);
+	CHECK(helper->get_global_transform().origin.is_equal_approx(parent->get_global_transform().xform(local.origin)));
+}
 } // namespace TestIKNode3D
 
 #endif // TEST_IK_NODE_3D_H
@@ -0,0 +1,649 @@
+/**************************************************************************/
+/*  test_many_bone_ik_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MANY_BONE_IK_3D_H
+#define TEST_MANY_BONE_IK_3D_H
+
+#include "modules/many_bone_ik/src/ik_bone_3d.h"
+#include "modules/many_bone_ik/src/ik_bone_segment_3d.h"
+#include "modules/many_bone_ik/src/ik_effector_3d.h"
+#include "modules/many_bone_ik/src/ik_solve_server_3d.h"
+#include "modules/many_bone_ik/src/many_bone_ik_3d.h"
+#include "modules/many_bone_ik/src/math/ik_transform_store_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_benchmark.h"
+#include "scene/3d/marker_3d.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "scene/resources/curve.h"
+#include "tests/test_macros.h"
+
+namespace TestManyBoneIK3D {
+
+using namespace TestManyBoneIK3DBenchmark;
+
+// Solves one frame from the rest pose at each precision and returns the largest distance between the resulting bone positions.
+static double _get_single_precision_drift(BenchmarkRig &r_rig) {
+	_attach_solver(r_rig);
+	ManyBoneIK3D *many_bone_ik = r_rig.many_bone_ik;
+	Skeleton3D *skeleton = r_rig.skeleton;
+	Vector<Vector3> double_positions;
+	skeleton->reset_bone_poses();
+	many_bone_ik->set_solver_precision(ManyBoneIK3D::SOLVER_PRECISION_DOUBLE);
+	many_bone_ik->process_modification();
+	for (int32_t bone_i = 0; bone_i < skeleton->get_bone_count(); bone_i++) {
+		double_positions.push_back(skeleton->get_bone_global_pose(bone_i).origin);
+	}
+	skeleton->reset_bone_poses();
+	many_bone_ik->set_solver_precision(ManyBoneIK3D::SOLVER_PRECISION_FLOAT);
+	many_bone_ik->process_modification();
+	double drift = 0.0;
+	for (int32_t bone_i = 0; bone_i < skeleton->get_bone_count(); bone_i++) {
+		drift = MAX(drift, double(skeleton->get_bone_global_pose(bone_i).origin.distance_to(double_positions[bone_i])));
+	}
+	_free_rig(r_rig);
+	return drift;
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Single precision solve stays close to double precision on the reference rigs") {
+	// Half a millimetre on rigs measured in metres.
+	const double tolerance = 5e-4;
+	BenchmarkRig humanoid = _create_humanoid();
+	double humanoid_drift = _get_single_precision_drift(humanoid);
+	CHECK_MESSAGE(humanoid_drift < tolerance, vformat("Humanoid drifted by %f.", humanoid_drift));
+	BenchmarkRig tentacle = _create_tentacle(50);
+	double tentacle_drift = _get_single_precision_drift(tentacle);
+	CHECK_MESSAGE(tentacle_drift < tolerance, vformat("Tentacle drifted by %f.", tentacle_drift));
+	BenchmarkRig hand = _create_hand(5, 3);
+	double hand_drift = _get_single_precision_drift(hand);
+	CHECK_MESSAGE(hand_drift < tolerance, vformat("Hand drifted by %f.", hand_drift));
+}
+
+// A ten bone tentacle with its tip pinned, and a target point within reach that it does not touch at rest.
+struct PinnedTentacle {
+	BenchmarkRig rig;
+	int32_t tip = -1;
+	Vector3 target;
+	double rest_distance = 0.0;
+};
+
+static PinnedTentacle _create_pinned_tentacle() {
+	PinnedTentacle tentacle;
+	tentacle.rig = _create_tentacle(10);
+	Skeleton3D *skeleton = tentacle.rig.skeleton;
+	_add_rig_node(tentacle.rig, skeleton);
+	ManyBoneIK3D *many_bone_ik = memnew(ManyBoneIK3D);
+	skeleton->add_child(many_bone_ik);
+	many_bone_ik->set_pin_count(1);
+	many_bone_ik->set_pin_bone_name(0, tentacle.rig.pinned_bones[0]);
+	many_bone_ik->process_modification();
+	tentacle.rig.many_bone_ik = many_bone_ik;
+
+	tentacle.tip = skeleton->find_bone(tentacle.rig.pinned_bones[0]);
+	tentacle.target = skeleton->get_bone_global_rest(tentacle.tip).origin + Vector3(0.2, -0.1, 0.0);
+	tentacle.rest_distance = skeleton->get_bone_global_pose(tentacle.tip).origin.distance_to(tentacle.target);
+	return tentacle;
+}
+
+static double _solve_pinned_tentacle(PinnedTentacle &r_tentacle, int32_t p_frames = 10) {
+	for (int32_t frame_i = 0; frame_i < p_frames; frame_i++) {
+		r_tentacle.rig.many_bone_ik->process_modification();
+	}
+	return r_tentacle.rig.skeleton->get_bone_global_pose(r_tentacle.tip).origin.distance_to(r_tentacle.target);
+}
+
+// Checks that two skeletons built the same way ended up in the same pose.
+static void _check_same_pose(const Skeleton3D *p_skeleton, const Skeleton3D *p_expected) {
+	REQUIRE(p_skeleton->get_bone_count() == p_expected->get_bone_count());
+	for (int32_t bone_i = 0; bone_i < p_skeleton->get_bone_count(); bone_i++) {
+		Transform3D pose = p_skeleton->get_bone_global_pose(bone_i);
+		Transform3D expected = p_expected->get_bone_global_pose(bone_i);
+		CHECK_MESSAGE(pose.is_equal_approx(expected), vformat("Bone %s differs: %s instead of %s.", p_skeleton->get_bone_name(bone_i), pose, expected));
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Fed pin targets drive the solve without target nodes") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target));
+	CHECK(many_bone_ik->get_pin_target_transform(0).origin.is_equal_approx(tentacle.target));
+	CHECK(_solve_pinned_tentacle(tentacle) < tentacle.rest_distance * 0.5);
+
+	// The bulk setters take the same transforms either packed or as an array, and ignore the extra ones.
+	Transform3D moved = Transform3D(Basis(Vector3(0, 1, 0), 0.3), tentacle.target + Vector3(0, 0.05, 0));
+	TypedArray<Transform3D> transforms;
+	transforms.push_back(moved);
+	transforms.push_back(Transform3D());
+	many_bone_ik->call(SNAME("set_pin_target_transform_array"), transforms);
+	CHECK(many_bone_ik->get_pin_target_transform(0).is_equal_approx(moved));
+	PackedFloat32Array packed;
+	for (int32_t row_i = 0; row_i < 3; row_i++) {
+		packed.push_back(Basis().rows[row_i].x);
+		packed.push_back(Basis().rows[row_i].y);
+		packed.push_back(Basis().rows[row_i].z);
+		packed.push_back(tentacle.target[row_i]);
+	}
+	many_bone_ik->call(SNAME("set_pin_target_transforms"), packed);
+	CHECK(many_bone_ik->get_pin_target_transform(0).is_equal_approx(Transform3D(Basis(), tentacle.target)));
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Pin blend weight fades a pin without a rebuild") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target));
+	many_bone_ik->set_pin_blend_weight(0, 0.0);
+	CHECK(Math::is_zero_approx(many_bone_ik->get_pin_blend_weight(0)));
+	CHECK(_solve_pinned_tentacle(tentacle) > tentacle.rest_distance * 0.9);
+
+	many_bone_ik->set_pin_blend_weight(0, 1.0);
+	CHECK(_solve_pinned_tentacle(tentacle) < tentacle.rest_distance * 0.5);
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Fully faded pins skip the segment solve") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_stabilization_passes(4);
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target));
+	many_bone_ik->set_pin_blend_weight(0, 0.0);
+	CHECK(Math::is_equal_approx(_solve_pinned_tentacle(tentacle, 1), tentacle.rest_distance));
+	CHECK(Math::is_finite(many_bone_ik->get_last_solve_error()));
+#ifdef DEBUG_ENABLED
+	CHECK(int64_t(many_bone_ik->get_solver_stats()["stabilization_rollbacks"]) == 0);
+#endif
+
+	// A falloff curve that reaches zero at the tip's distance fades the pin out just the same.
+	Ref<Curve> falloff;
+	falloff.instantiate();
+	falloff->add_point(Vector2(0, 0));
+	falloff->add_point(Vector2(1, 0));
+	many_bone_ik->set_pin_blend_weight(0, 1.0);
+	many_bone_ik->set_pin_weight_falloff_curve(0, falloff);
+	CHECK(Math::is_equal_approx(_solve_pinned_tentacle(tentacle, 1), tentacle.rest_distance));
+#ifdef DEBUG_ENABLED
+	CHECK(int64_t(many_bone_ik->get_solver_stats()["stabilization_rollbacks"]) == 0);
+#endif
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Convergence stops the solve early on a reached target") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	const int32_t iterations = 20;
+	many_bone_ik->set_iterations_per_frame(iterations);
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target));
+	_solve_pinned_tentacle(tentacle, 1);
+	CHECK(many_bone_ik->get_last_iteration_count() == iterations);
+	CHECK(many_bone_ik->get_last_solve_error() < 0.0);
+
+	// After a few frames the tip sits on the target, so the error stops improving within the first iterations.
+	many_bone_ik->set_convergence_enabled(true);
+	_solve_pinned_tentacle(tentacle, 10);
+	int32_t iteration_count = many_bone_ik->get_last_iteration_count();
+	double error = many_bone_ik->get_last_solve_error();
+	CHECK(iteration_count > 0);
+	CHECK_MESSAGE(iteration_count < iterations, vformat("Used %d of %d iterations.", iteration_count, iterations));
+	CHECK(Math::is_finite(error));
+	CHECK(error >= 0.0);
+
+	// A far target keeps improving, so it costs more iterations and reports a larger error.
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target + Vector3(-0.3, 0.2, 0.3)));
+	_solve_pinned_tentacle(tentacle, 1);
+	CHECK(many_bone_ik->get_last_iteration_count() > iteration_count);
+	CHECK(many_bone_ik->get_last_solve_error() > error);
+	_free_rig(tentacle.rig);
+}
+
+// Checks that the solver still holds the same segment and bone instances it had before an edit.
+static void _check_same_instances(ManyBoneIK3D *p_many_bone_ik, const Vector<Ref<IKBoneSegment3D>> &p_segments, const Vector<Ref<IKBone3D>> &p_bones) {
+	CHECK(p_many_bone_ik->get_segmented_skeletons() == p_segments);
+	CHECK(p_many_bone_ik->get_bone_list() == p_bones);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Effector, constraint and damping edits update the solver in place") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	Skeleton3D *skeleton = tentacle.rig.skeleton;
+	const String constrained_bone = skeleton->get_bone_name(5);
+	many_bone_ik->call(SNAME("set_constraint_count"), 1);
+	many_bone_ik->set_constraint_name_at_index(0, constrained_bone);
+	many_bone_ik->process_modification();
+	const Vector<Ref<IKBoneSegment3D>> segments = many_bone_ik->get_segmented_skeletons();
+	const Vector<Ref<IKBone3D>> bones = many_bone_ik->get_bone_list();
+	REQUIRE(!segments.is_empty());
+	Ref<IKBone3D> tip_bone = segments[0]->get_ik_bone(tentacle.tip);
+	Ref<IKBone3D> ik_bone = segments[0]->get_ik_bone(5);
+	REQUIRE(tip_bone.is_valid());
+	REQUIRE(ik_bone.is_valid());
+	REQUIRE(ik_bone->get_constraint().is_valid());
+
+	many_bone_ik->set_pin_weight(0, 0.25);
+	many_bone_ik->process_modification();
+	_check_same_instances(many_bone_ik, segments, bones);
+	CHECK(Math::is_equal_approx(tip_bone->get_pin()->get_weight(), real_t(0.25)));
+
+	many_bone_ik->set_kusudama_resistance(0, 0.5);
+	many_bone_ik->process_modification();
+	_check_same_instances(many_bone_ik, segments, bones);
+	REQUIRE(ik_bone->get_constraint().is_valid());
+	CHECK(Math::is_equal_approx(ik_bone->get_constraint()->get_resistance(), 0.5f));
+
+	many_bone_ik->set_default_damp(0.1);
+	many_bone_ik->process_modification();
+	_check_same_instances(many_bone_ik, segments, bones);
+	CHECK(Math::is_equal_approx(ik_bone->get_cos_half_dampen(), float(Math::cos(0.05))));
+
+	// Renaming a constraint moves it to another bone, which does need a rebuild.
+	many_bone_ik->set_constraint_name_at_index(0, skeleton->get_bone_name(6));
+	many_bone_ik->process_modification();
+	CHECK(many_bone_ik->get_bone_list() != bones);
+	_free_rig(tentacle.rig);
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Solver stats report the last frame") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), tentacle.target));
+	_solve_pinned_tentacle(tentacle, 1);
+	Dictionary stats = many_bone_ik->get_solver_stats();
+	CHECK(int32_t(stats["iterations"]) == many_bone_ik->get_last_iteration_count());
+	PackedFloat64Array first_errors = stats["effector_errors"];
+	REQUIRE(first_errors.size() == 1);
+	const double first_error = first_errors[0];
+	CHECK(first_error >= 0.0);
+
+	// The stats handed out earlier keep their values while the solver refills its own.
+	_solve_pinned_tentacle(tentacle, 10);
+	PackedFloat64Array errors = many_bone_ik->get_solver_stats()["effector_errors"];
+	REQUIRE(errors.size() == 1);
+	CHECK(errors[0] < first_error);
+	CHECK(first_errors[0] == first_error);
+
+	// A pin without a bone is reported as unresolved.
+	many_bone_ik->set_pin_count(2);
+	_solve_pinned_tentacle(tentacle, 1);
+	errors = many_bone_ik->get_solver_stats()["effector_errors"];
+	REQUIRE(errors.size() == 2);
+	CHECK(errors[0] >= 0.0);
+	CHECK(errors[1] == -1.0);
+	_free_rig(tentacle.rig);
+}
+#endif
+
+TEST_CASE("[Modules][ManyBoneIK] Effector falloff follows edits to its curve") {
+	Ref<IKEffector3D> effector;
+	effector.instantiate();
+	effector->set_target_transform(Transform3D());
+	effector->set_weight_falloff_distance(1.0);
+	Ref<Curve> falloff;
+	falloff.instantiate();
+	falloff->add_point(Vector2(0, 1));
+	falloff->add_point(Vector2(1, 0));
+	effector->set_weight_falloff_curve(falloff);
+	CHECK(Math::is_equal_approx(effector->get_heading_weight_scale(Vector3()), 1.0));
+	CHECK(Math::is_equal_approx(effector->get_heading_weight_scale(Vector3(0.5, 0, 0)), 0.5, 0.02));
+	CHECK(Math::is_zero_approx(effector->get_heading_weight_scale(Vector3(2, 0, 0))));
+
+	// Edits made after the curve was assigned reach the effector without assigning it again.
+	falloff->set_point_value(1, 1.0);
+	CHECK(Math::is_equal_approx(effector->get_heading_weight_scale(Vector3(0.5, 0, 0)), 1.0, 0.02));
+
+	effector->set_weight_falloff_curve(Ref<Curve>());
+	falloff->set_point_value(1, 0.0);
+	CHECK(Math::is_equal_approx(effector->get_heading_weight_scale(Vector3(2, 0, 0)), 1.0));
+}
+
+static Ref<IKEffector3D> _get_tip_effector(PinnedTentacle &r_tentacle) {
+	Vector<Ref<IKBoneSegment3D>> segments = r_tentacle.rig.many_bone_ik->get_segmented_skeletons();
+	REQUIRE(!segments.is_empty());
+	Ref<IKBone3D> tip_bone = segments[0]->get_ik_bone(r_tentacle.tip);
+	REQUIRE(tip_bone.is_valid());
+	return tip_bone->get_pin();
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Static pin targets stay fixed in the world") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	Marker3D *target = memnew(Marker3D);
+	_add_rig_node(tentacle.rig, target);
+	target->set_global_transform(Transform3D(Basis(), tentacle.target));
+	many_bone_ik->set_pin_target_node_path(0, many_bone_ik->get_path_to(target));
+	many_bone_ik->set_pin_target_static(0, true);
+	many_bone_ik->process_modification();
+	Ref<IKEffector3D> effector = _get_tip_effector(tentacle);
+	REQUIRE(effector.is_valid());
+
+	// The node is read once, but the skeleton moving under it still moves the target relative to the skeleton.
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	target->set_global_transform(Transform3D(Basis(), tentacle.target + Vector3(0, 1, 0)));
+	Transform3D skeleton_global = Transform3D(Basis(), Vector3(1, 0, 0));
+	effector->update_target_global_transform(skeleton_global.affine_inverse(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(tentacle.target - Vector3(1, 0, 0)));
+
+	// Feeding and then clearing a transform goes back to the node, which is read once more.
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(), Vector3(5, 5, 5)));
+	many_bone_ik->clear_pin_target_transform(0);
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(tentacle.target + Vector3(0, 1, 0)));
+
+	// So is a target node whose cache was dropped after the tree changed.
+	target->set_global_transform(Transform3D(Basis(), tentacle.target));
+	effector->clear_target_node_cache();
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(tentacle.target));
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Target node caches only drop when the target's path changes") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	Node3D *holder = memnew(Node3D);
+	holder->set_name("TargetHolder");
+	_add_rig_node(tentacle.rig, holder);
+	Marker3D *target = memnew(Marker3D);
+	holder->add_child(target);
+	target->set_global_transform(Transform3D(Basis(), tentacle.target));
+	many_bone_ik->set_pin_target_node_path(0, many_bone_ik->get_path_to(target));
+	// A static target is only read again once its cache is dropped, which makes the drops visible.
+	many_bone_ik->set_pin_target_static(0, true);
+	many_bone_ik->process_modification();
+	Ref<IKEffector3D> effector = _get_tip_effector(tentacle);
+	REQUIRE(effector.is_valid());
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(tentacle.target));
+
+	// Nodes coming and going elsewhere in the tree leave the cache alone.
+	const Vector3 moved = tentacle.target + Vector3(0, 0.1, 0);
+	target->set_global_transform(Transform3D(Basis(), moved));
+	Node3D *unrelated = memnew(Node3D);
+	Node *root = SceneTree::get_singleton()->get_root();
+	root->add_child(unrelated);
+	root->remove_child(unrelated);
+	memdelete(unrelated);
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(tentacle.target));
+
+	// Renaming an ancestor on the target's path drops it, and the path resolves again once the name is restored.
+	holder->set_name("RenamedTargetHolder");
+	holder->set_name("TargetHolder");
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(moved));
+
+	// So does the target leaving the tree, even when it comes back under the same path.
+	const Vector3 moved_again = tentacle.target + Vector3(0, 0.2, 0);
+	holder->remove_child(target);
+	holder->add_child(target);
+	target->set_global_transform(Transform3D(Basis(), moved_again));
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_global_transform().origin.is_equal_approx(moved_again));
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Cached target points recenter to the per bone target headings") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	Ref<IKEffector3D> effector = _get_tip_effector(tentacle);
+	REQUIRE(effector.is_valid());
+	effector->set_direction_priorities(Vector3(0.5, 0.0, 0.25));
+	Transform3D target = Transform3D(Basis(Vector3(1, 1, 0).normalized(), 0.7), tentacle.target);
+	effector->set_target_transform(target);
+
+	const int32_t heading_count = effector->get_target_heading_count();
+	REQUIRE(heading_count == 5);
+	Vector<double> weights;
+	for (int32_t heading_i = 0; heading_i < heading_count; heading_i++) {
+		weights.push_back(heading_i == 0 ? 1.0 : 0.3 * heading_i);
+	}
+	Vector<Vector3> points;
+	points.resize(heading_count);
+	Vector<Vector3> headings;
+	headings.resize(heading_count);
+	CHECK(effector->update_effector_target_points(points.ptrw(), 0, weights.ptr()) == heading_count);
+	CHECK(effector->recenter_target_headings(points.ptr(), headings.ptrw(), 0, weights.ptr()) == heading_count);
+
+	// The headings each bone used to build from scratch: the target frame relative to the bone origin, scaled by the weight.
+	Vector3 bone_origin = effector->get_ik_bone_3d()->get_bone_direction_global_pose().origin;
+	CHECK(headings[0].is_equal_approx(target.origin - bone_origin));
+	int32_t index = 1;
+	for (int axis = Vector3::AXIS_X; axis <= Vector3::AXIS_Z; ++axis) {
+		if (effector->get_direction_priorities()[axis] <= 0.0) {
+			continue;
+		}
+		Vector3 column = target.basis.get_column(axis);
+		CHECK(headings[index].is_equal_approx(((column + target.origin) - bone_origin) * weights[index]));
+		CHECK(headings[index + 1].is_equal_approx(((target.origin - column) - bone_origin) * weights[index + 1]));
+		index += 2;
+	}
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Target version changes whenever the cached target points go stale") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	Marker3D *target = memnew(Marker3D);
+	_add_rig_node(tentacle.rig, target);
+	target->set_global_transform(Transform3D(Basis(), tentacle.target));
+	many_bone_ik->set_pin_target_node_path(0, many_bone_ik->get_path_to(target));
+	many_bone_ik->process_modification();
+	Ref<IKEffector3D> effector = _get_tip_effector(tentacle);
+	REQUIRE(effector.is_valid());
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+
+	uint32_t version = effector->get_target_version();
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK_MESSAGE(effector->get_target_version() == version, "A target that did not move must keep its cached points.");
+
+	target->set_global_transform(Transform3D(Basis(), tentacle.target + Vector3(0, 0.1, 0)));
+	effector->update_target_global_transform(Transform3D(), many_bone_ik);
+	CHECK(effector->get_target_version() != version);
+
+	version = effector->get_target_version();
+	effector->set_weight(effector->get_weight() + 0.5);
+	CHECK(effector->get_target_version() != version);
+
+	version = effector->get_target_version();
+	// Same axes as the segment was built with, so only the heading values change.
+	effector->set_direction_priorities(effector->get_direction_priorities() * 2.0);
+	CHECK(effector->get_target_version() != version);
+
+	version = effector->get_target_version();
+	effector->set_target_transform(Transform3D(Basis(), tentacle.target));
+	CHECK(effector->get_target_version() != version);
+
+	// The solve picks the moved target up through the rebuilt points.
+	CHECK(_solve_pinned_tentacle(tentacle) < tentacle.rest_distance * 0.5);
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Carried tip headings match headings read from the store") {
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_pin_direction_priorities(0, Vector3(0.2, 0.2, 0.2));
+	// Stabilization rolls bones back mid pass, which the carried tip frames have to follow as well.
+	many_bone_ik->set_stabilization_passes(4);
+	many_bone_ik->set_pin_target_transform(0, Transform3D(Basis(Vector3(1, 0, 0), 0.8), tentacle.target + Vector3(-0.2, 0.1, 0.3)));
+	Vector<Ref<IKBoneSegment3D>> segments = many_bone_ik->get_segmented_skeletons();
+	REQUIRE(!segments.is_empty());
+	Ref<IKBoneSegment3D> segment = segments[0];
+	Ref<IKEffector3D> effector = _get_tip_effector(tentacle);
+	REQUIRE(effector.is_valid());
+
+	for (int32_t frame_i = 0; frame_i < 3; frame_i++) {
+		many_bone_ik->process_modification();
+		for (const Ref<IKBone3D> &ik_bone : many_bone_ik->get_bone_list()) {
+			if (segment->get_ik_bone(ik_bone->get_bone_id()).is_null()) {
+				continue;
+			}
+			PackedVector3Array carried = segment->get_carried_tip_headings(ik_bone);
+			REQUIRE(!carried.is_empty());
+			PackedVector3Array expected;
+			expected.resize(carried.size());
+			REQUIRE(effector->update_effector_tip_headings(&expected, 0, ik_bone) == carried.size());
+			for (int32_t heading_i = 0; heading_i < carried.size(); heading_i++) {
+				CHECK_MESSAGE(carried[heading_i].distance_to(expected[heading_i]) < 1e-4, vformat("Heading %d of bone %d drifted from %s to %s.", heading_i, ik_bone->get_bone_id(), expected[heading_i], carried[heading_i]));
+			}
+		}
+	}
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Solve server tracks batched modifiers in the tree") {
+	IKSolveServer3D *solve_server = IKSolveServer3D::get_singleton();
+	REQUIRE(solve_server);
+	const int32_t modifier_count = solve_server->get_modifier_count();
+	PinnedTentacle tentacle = _create_pinned_tentacle();
+	ManyBoneIK3D *many_bone_ik = tentacle.rig.many_bone_ik;
+	many_bone_ik->set_batched_solve(true);
+	CHECK(solve_server->get_modifier_count() == modifier_count + 1);
+	many_bone_ik->set_batched_solve(true);
+	CHECK(solve_server->get_modifier_count() == modifier_count + 1);
+
+	tentacle.rig.skeleton->remove_child(many_bone_ik);
+	CHECK(solve_server->get_modifier_count() == modifier_count);
+	tentacle.rig.skeleton->add_child(many_bone_ik);
+	CHECK(solve_server->get_modifier_count() == modifier_count + 1);
+
+	many_bone_ik->set_batched_solve(false);
+	CHECK(solve_server->get_modifier_count() == modifier_count);
+	_free_rig(tentacle.rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Batched solves write back the same poses as serial solves") {
+	const int32_t rig_count = 3;
+	PinnedTentacle batched[rig_count];
+	PinnedTentacle serial[rig_count];
+	for (int32_t rig_i = 0; rig_i < rig_count; rig_i++) {
+		batched[rig_i] = _create_pinned_tentacle();
+		serial[rig_i] = _create_pinned_tentacle();
+		Transform3D target = Transform3D(Basis(), batched[rig_i].target + Vector3(0, 0, 0.05 * rig_i));
+		batched[rig_i].rig.many_bone_ik->set_pin_target_transform(0, target);
+		serial[rig_i].rig.many_bone_ik->set_pin_target_transform(0, target);
+		batched[rig_i].rig.many_bone_ik->set_batched_solve(true);
+	}
+
+	SceneTree *tree = SceneTree::get_singleton();
+	for (int32_t frame_i = 0; frame_i < 3; frame_i++) {
+		tree->emit_signal(SNAME("process_frame"));
+		// The first modifier solves the whole batch, the others only write their result back.
+		for (int32_t rig_i = 0; rig_i < rig_count; rig_i++) {
+			batched[rig_i].rig.many_bone_ik->process_modification();
+			serial[rig_i].rig.many_bone_ik->process_modification();
+		}
+		for (int32_t rig_i = 0; rig_i < rig_count; rig_i++) {
+			_check_same_pose(batched[rig_i].rig.skeleton, serial[rig_i].rig.skeleton);
+		}
+	}
+	for (int32_t rig_i = 0; rig_i < rig_count; rig_i++) {
+		_free_rig(batched[rig_i].rig);
+		_free_rig(serial[rig_i].rig);
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Batched results left over from a skipped update are solved again") {
+	PinnedTentacle first = _create_pinned_tentacle();
+	PinnedTentacle skipped = _create_pinned_tentacle();
+	PinnedTentacle serial = _create_pinned_tentacle();
+	Transform3D target = Transform3D(Basis(), first.target);
+	for (PinnedTentacle *tentacle : { &first, &skipped, &serial }) {
+		tentacle->rig.many_bone_ik->set_pin_target_transform(0, target);
+	}
+	first.rig.many_bone_ik->set_batched_solve(true);
+	skipped.rig.many_bone_ik->set_batched_solve(true);
+
+	// The first modifier solves both, but the second skeleton is not processed in this frame.
+	SceneTree *tree = SceneTree::get_singleton();
+	tree->emit_signal(SNAME("process_frame"));
+	first.rig.many_bone_ik->process_modification();
+
+	// The next frame moves the target, so writing back the old result would miss it.
+	tree->emit_signal(SNAME("process_frame"));
+	Transform3D moved = Transform3D(Basis(), target.origin + Vector3(-0.1, 0.05, 0.1));
+	skipped.rig.many_bone_ik->set_pin_target_transform(0, moved);
+	serial.rig.many_bone_ik->set_pin_target_transform(0, moved);
+	skipped.rig.many_bone_ik->process_modification();
+	serial.rig.many_bone_ik->process_modification();
+	_check_same_pose(skipped.rig.skeleton, serial.rig.skeleton);
+	_free_rig(first.rig);
+	_free_rig(skipped.rig);
+	_free_rig(serial.rig);
+}
+
+// Several unconnected chains, so the skeleton has one root segment per chain.
+static BenchmarkRig _create_chains(int32_t p_chain_count, int32_t p_chain_length) {
+	BenchmarkRig rig;
+	rig.skeleton = memnew(Skeleton3D);
+	for (int32_t chain_i = 0; chain_i < p_chain_count; chain_i++) {
+		real_t spread = Math_TAU * chain_i / p_chain_count;
+		int32_t tip = _add_chain(rig.skeleton, -1, "Chain" + itos(chain_i) + "_", p_chain_length, Basis(Vector3(0, 1, 0), spread) * Basis(Vector3(0, 0, 1), 0.3), 0.1);
+		rig.pinned_bones.push_back(rig.skeleton->get_bone_name(tip));
+	}
+	return rig;
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Threaded root segments match the serial solve") {
+	BenchmarkRig threaded = _create_chains(4, 6);
+	BenchmarkRig serial = _create_chains(4, 6);
+	_attach_solver(threaded);
+	_attach_solver(serial);
+	REQUIRE(threaded.many_bone_ik->get_segmented_skeletons().size() == 4);
+	threaded.many_bone_ik->set_thread_count(4);
+	serial.many_bone_ik->set_thread_count(1);
+	for (int32_t frame_i = 0; frame_i < 5; frame_i++) {
+		threaded.many_bone_ik->process_modification();
+		serial.many_bone_ik->process_modification();
+		_check_same_pose(threaded.skeleton, serial.skeleton);
+	}
+	_free_rig(threaded);
+	_free_rig(serial);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][SceneTree] Parallel child segments match the depth-first solve") {
+	BenchmarkRig parallel = _create_humanoid();
+	BenchmarkRig depth_first = _create_humanoid();
+	_attach_solver(parallel);
+	_attach_solver(depth_first);
+	Vector<Ref<IKBoneSegment3D>> segments = parallel.many_bone_ik->get_segmented_skeletons();
+	REQUIRE(!segments.is_empty());
+	REQUIRE(segments[0]->get_child_segments().size() > 1);
+	parallel.many_bone_ik->set_parallel_child_segments(true);
+	depth_first.many_bone_ik->set_parallel_child_segments(false);
+	for (int32_t frame_i = 0; frame_i < 5; frame_i++) {
+		parallel.many_bone_ik->process_modification();
+		depth_first.many_bone_ik->process_modification();
+		_check_same_pose(parallel.skeleton, depth_first.skeleton);
+	}
+	_free_rig(parallel);
+	_free_rig(depth_first);
+}
+
+} // namespace TestManyBoneIK3D
+
+#endif // TEST_MANY_BONE_IK_3D_H
@@ -0,0 +1,289 @@
+/**************************************************************************/
+/*  test_many_bone_ik_3d_benchmark.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MANY_BONE_IK_3D_BENCHMARK_H
+#define TEST_MANY_BONE_IK_3D_BENCHMARK_H
+
+#include "core/io/json.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "modules/many_bone_ik/src/ik_bone_segment_3d.h"
+#include "modules/many_bone_ik/src/ik_kusudama_3d.h"
+#include "modules/many_bone_ik/src/ik_open_cone_3d.h"
+#include "modules/many_bone_ik/src/many_bone_ik_3d.h"
+#include "modules/many_bone_ik/src/math/qcp.h"
+#include "scene/3d/marker_3d.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "tests/test_macros.h"
+
+// Timing runs for the solver hot paths. They are skipped by default; run them with
+// `--test-case="*[Benchmark]*" --no-skip`. Each case prints one JSON line prefixed
+// with MANY_BONE_IK_BENCHMARK so results can be collected and compared over time.
+// MANY_BONE_IK_BENCHMARK_FRAMES overrides the number of timed runs per measurement.
+// The rigs are shared with the solver tests in test_many_bone_ik_3d.h.
+
+namespace TestManyBoneIK3DBenchmark {
+
+struct BenchmarkRig {
+	Skeleton3D *skeleton = nullptr;
+	ManyBoneIK3D *many_bone_ik = nullptr;
+	Vector<String> pinned_bones;
+	// Nodes the rig added to the root, freed together with their children by _free_rig.
+	Vector<Node *> nodes;
+};
+
+static int32_t _get_frame_count() {
+	String frames = OS::get_singleton()->get_environment("MANY_BONE_IK_BENCHMARK_FRAMES");
+	return frames.is_valid_int() ? MAX(1, frames.to_int()) : 200;
+}
+
+template <typename F>
+static double _time_usec(int32_t p_runs, F p_function) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int32_t run_i = 0; run_i < p_runs; run_i++) {
+		p_function();
+	}
+	return double(OS::get_singleton()->get_ticks_usec() - begin) / p_runs;
+}
+
+static int32_t _add_chain(Skeleton3D *p_skeleton, int32_t p_parent, const String &p_prefix, int32_t p_length, const Basis &p_spread, real_t p_bone_length) {
+	int32_t parent = p_parent;
+	for (int32_t bone_i = 0; bone_i < p_length; bone_i++) {
+		int32_t bone = p_skeleton->get_bone_count();
+		p_skeleton->add_bone(p_prefix + itos(bone_i));
+		p_skeleton->set_bone_parent(bone, parent);
+		Basis basis = bone_i == 0 ? p_spread : Basis();
+		p_skeleton->set_bone_rest(bone, Transform3D(basis, Vector3(0, p_bone_length, 0)));
+		parent = bone;
+	}
+	return parent;
+}
+
+static BenchmarkRig _create_humanoid() {
+	BenchmarkRig rig;
+	rig.skeleton = memnew(Skeleton3D);
+	Skeleton3D *skeleton = rig.skeleton;
+	int32_t chest = _add_chain(skeleton, -1, "Spine", 4, Basis(), 0.15);
+	int32_t head = _add_chain(skeleton, chest, "Head", 2, Basis(), 0.1);
+	int32_t left_hand = _add_chain(skeleton, chest, "LeftArm", 4, Basis(Vector3(0, 0, 1), Math_PI * 0.5), 0.25);
+	int32_t right_hand = _add_chain(skeleton, chest, "RightArm", 4, Basis(Vector3(0, 0, 1), -Math_PI * 0.5), 0.25);
+	int32_t left_foot = _add_chain(skeleton, 0, "LeftLeg", 4, Basis(Vector3(0, 0, 1), Math_PI * 0.9), 0.4);
+	int32_t right_foot = _add_chain(skeleton, 0, "RightLeg", 4, Basis(Vector3(0, 0, 1), -Math_PI * 0.9), 0.4);
+	for (int32_t tip : { head, left_hand, right_hand, left_foot, right_foot }) {
+		rig.pinned_bones.push_back(skeleton->get_bone_name(tip));
+	}
+	return rig;
+}
+
+static BenchmarkRig _create_tentacle(int32_t p_bone_count) {
+	BenchmarkRig rig;
+	rig.skeleton = memnew(Skeleton3D);
+	int32_t tip = _add_chain(rig.skeleton, -1, "Tentacle", p_bone_count, Basis(), 0.05);
+	rig.pinned_bones.push_back(rig.skeleton->get_bone_name(tip));
+	return rig;
+}
+
+static BenchmarkRig _create_hand(int32_t p_finger_count, int32_t p_finger_length) {
+	BenchmarkRig rig;
+	rig.skeleton = memnew(Skeleton3D);
+	int32_t wrist = _add_chain(rig.skeleton, -1, "Wrist", 1, Basis(), 0.0);
+	for (int32_t finger_i = 0; finger_i < p_finger_count; finger_i++) {
+		real_t spread = Math::lerp(-Math_PI * 0.4, Math_PI * 0.4, real_t(finger_i) / MAX(1, p_finger_count - 1));
+		int32_t tip = _add_chain(rig.skeleton, wrist, "Finger" + itos(finger_i) + "_", p_finger_length, Basis(Vector3(0, 0, 1), spread), 0.03);
+		rig.pinned_bones.push_back(rig.skeleton->get_bone_name(tip));
+	}
+	return rig;
+}
+
+static void _add_rig_node(BenchmarkRig &r_rig, Node *p_node) {
+	SceneTree::get_singleton()->get_root()->add_child(p_node);
+	r_rig.nodes.push_back(p_node);
+}
+
+static void _attach_solver(BenchmarkRig &r_rig) {
+	_add_rig_node(r_rig, r_rig.skeleton);
+	r_rig.many_bone_ik = memnew(ManyBoneIK3D);
+	r_rig.skeleton->add_child(r_rig.many_bone_ik);
+	r_rig.many_bone_ik->set_pin_count(r_rig.pinned_bones.size());
+	for (int32_t pin_i = 0; pin_i < r_rig.pinned_bones.size(); pin_i++) {
+		const String &bone_name = r_rig.pinned_bones[pin_i];
+		Marker3D *target = memnew(Marker3D);
+		_add_rig_node(r_rig, target);
+		Transform3D bone_global = r_rig.skeleton->get_bone_global_rest(r_rig.skeleton->find_bone(bone_name));
+		target->set_global_transform(Transform3D(bone_global.basis, bone_global.origin + Vector3(0.1, -0.05, 0.1)));
+		r_rig.many_bone_ik->set_pin_bone_name(pin_i, bone_name);
+		r_rig.many_bone_ik->set_pin_target_node_path(pin_i, r_rig.many_bone_ik->get_path_to(target));
+	}
+	r_rig.many_bone_ik->process_modification();
+}
+
+static void _free_rig(BenchmarkRig &r_rig) {
+	for (int32_t node_i = r_rig.nodes.size(); node_i-- > 0;) {
+		Node *node = r_rig.nodes[node_i];
+		node->get_parent()->remove_child(node);
+		memdelete(node);
+	}
+	r_rig = BenchmarkRig();
+}
+
+static void _run_skeleton_benchmark(const String &p_rig_name, BenchmarkRig &r_rig) {
+	_attach_solver(r_rig);
+	ManyBoneIK3D *many_bone_ik = r_rig.many_bone_ik;
+	Skeleton3D *skeleton = r_rig.skeleton;
+	const int32_t frames = _get_frame_count();
+	const int32_t bone_count = many_bone_ik->get_bone_list().size();
+	const int32_t iterations = many_bone_ik->get_iterations_per_frame();
+	REQUIRE(bone_count > 0);
+
+	double rebuild_usec = _time_usec(MAX(1, frames / 10), [&]() {
+		skeleton->emit_signal(SNAME("bone_list_changed"));
+	});
+
+	Vector<Ref<IKBoneSegment3D>> segments = many_bone_ik->get_segmented_skeletons();
+	Vector<float> damp;
+	double iteration_usec = _time_usec(frames, [&]() {
+		for (Ref<IKBoneSegment3D> segment : segments) {
+			segment->segment_solver(damp, many_bone_ik->get_default_damp(), false, 0, iterations);
+		}
+	});
+
+#ifdef DEBUG_ENABLED
+	uint64_t allocs_before = Memory::get_num_allocs();
+#endif
+	double frame_usec = _time_usec(frames, [&]() {
+		many_bone_ik->process_modification();
+	});
+#ifdef DEBUG_ENABLED
+	// Every allocation counts, including the ones freed again within the frame.
+	double allocs_per_frame = double(Memory::get_num_allocs() - allocs_before) / frames;
+#endif
+
+	Dictionary result;
+	result["rig"] = p_rig_name;
+	result["bones"] = bone_count;
+	result["pins"] = r_rig.pinned_bones.size();
+	result["iterations"] = iterations;
+	result["frames"] = frames;
+	result["rebuild_usec"] = rebuild_usec;
+	result["segment_iteration_usec"] = iteration_usec;
+	result["frame_usec"] = frame_usec;
+	result["ns_per_bone_iteration"] = frame_usec * 1000.0 / (double(bone_count) * MAX(1, iterations));
+#ifdef DEBUG_ENABLED
+	result["allocs_per_frame"] = allocs_per_frame;
+#endif
+	print_line("MANY_BONE_IK_BENCHMARK " + JSON::stringify(result));
+
+	CHECK(frame_usec >= 0.0);
+	_free_rig(r_rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][Benchmark][SceneTree] Humanoid" * doctest::skip()) {
+	BenchmarkRig rig = _create_humanoid();
+	_run_skeleton_benchmark("humanoid", rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][Benchmark][SceneTree] 200 bone tentacle" * doctest::skip()) {
+	BenchmarkRig rig = _create_tentacle(200);
+	_run_skeleton_benchmark("tentacle_200", rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][Benchmark][SceneTree] 30 finger hand with every tip pinned" * doctest::skip()) {
+	BenchmarkRig rig = _create_hand(30, 3);
+	_run_skeleton_benchmark("hand_30", rig);
+}
+
+TEST_CASE("[Modules][ManyBoneIK][Benchmark] QCP superposition" * doctest::skip()) {
+	const int32_t frames = _get_frame_count() * 100;
+	// Seven headings per effector for a handful of effectors, as a typical segment would see.
+	const uint32_t count = 7 * 5;
+	Vector<Vector3> moved;
+	Vector<Vector3> target;
+	Vector<double> weight;
+	Quaternion rotation_to_find = Quaternion(Vector3(0.3, 0.8, 0.1).normalized(), 0.7);
+	for (uint32_t i = 0; i < count; i++) {
+		Vector3 point = Vector3(Math::sin(i * 0.5), Math::cos(i * 0.3), i * 0.01);
+		moved.push_back(point);
+		target.push_back(rotation_to_find.xform(point));
+		weight.push_back(1.0 + (i % 3));
+	}
+	QCPSolver solver;
+	Quaternion rotation;
+	Vector3 translation;
+	double superpose_usec = _time_usec(frames, [&]() {
+		solver.weighted_superpose(moved.ptr(), target.ptr(), weight.ptr(), count, false, rotation, translation);
+	});
+
+	Dictionary result;
+	result["rig"] = "qcp";
+	result["headings"] = count;
+	result["frames"] = frames;
+	result["simd"] = QCPSolver::has_simd();
+	result["ns_per_superpose"] = superpose_usec * 1000.0;
+	print_line("MANY_BONE_IK_BENCHMARK " + JSON::stringify(result));
+	CHECK(rotation.is_normalized());
+}
+
+TEST_CASE("[Modules][ManyBoneIK][Benchmark] Kusudama point in limits" * doctest::skip()) {
+	const int32_t frames = _get_frame_count() * 100;
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	const Vector3 control_points[] = { Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(0, 1, 1) };
+	for (const Vector3 &control_point : control_points) {
+		Ref<IKLimitCone3D> cone;
+		cone.instantiate();
+		cone->set_attached_to(kusudama);
+		cone->set_radius(Math_PI / 8);
+		cone->set_control_point(control_point.normalized());
+		kusudama->add_open_cone(cone);
+	}
+	Vector<double> bounds;
+	bounds.resize(2);
+	Vector3 accumulated;
+	int32_t sample_i = 0;
+	double query_usec = _time_usec(frames, [&]() {
+		real_t t = sample_i++ * 0.618;
+		Vector3 point = Vector3(Math::cos(t), Math::sin(t * 0.37), Math::sin(t)).normalized();
+		accumulated += kusudama->get_local_point_in_limits(point, &bounds);
+	});
+
+	Dictionary result;
+	result["rig"] = "kusudama";
+	result["cones"] = 3;
+	result["frames"] = frames;
+	result["ns_per_query"] = query_usec * 1000.0;
+	print_line("MANY_BONE_IK_BENCHMARK " + JSON::stringify(result));
+	CHECK(accumulated.is_finite());
+}
+
+} // namespace TestManyBoneIK3DBenchmark
+
+#endif // TEST_MANY_BONE_IK_3D_BENCHMARK_H
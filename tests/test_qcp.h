@@ -138,6 +138,72 @@ TEST_CASE("[Modules][QCP] Random Rotation and Translation") {
 	CHECK(abs(translation_result.z - expected_translation.z) < epsilon);
 }
 
+TEST_CASE("[Modules][QCP] Vectorized sums match the scalar path") {
+	// An odd count exercises both the paired lanes and the scalar tail.
+	const uint32_t count = 23;
+	LocalVector<double> headings;
+	headings.resize(count * QCPSolver::ROW_MAX);
+	for (uint32_t i = 0; i < count; i++) {
+		double t = i * 0.37;
+		headings[QCPSolver::ROW_TARGET_X * count + i] = Math::sin(t) * 3.0;
+		headings[QCPSolver::ROW_TARGET_Y * count + i] = Math::cos(t * 1.3) * 2.0;
+		headings[QCPSolver::ROW_TARGET_Z * count + i] = t - 4.0;
+		headings[QCPSolver::ROW_MOVED_X * count + i] = Math::cos(t) * 1.5;
+		headings[QCPSolver::ROW_MOVED_Y * count + i] = Math::sin(t * 0.7) - 0.5;
+		headings[QCPSolver::ROW_MOVED_Z * count + i] = 2.0 - t * 0.25;
+		headings[QCPSolver::ROW_WEIGHT * count + i] = 0.25 + (i % 4) * 0.5;
+	}
+
+	QCPHeadingSums scalar;
+	QCPHeadingSums vectorized;
+	QCPSolver::accumulate_sums_scalar(headings.ptr(), count, scalar);
+	QCPSolver::accumulate_sums(headings.ptr(), count, vectorized);
+
+	double epsilon = 1e-9;
+	CHECK(abs(scalar.xx - vectorized.xx) < epsilon);
+	CHECK(abs(scalar.xy - vectorized.xy) < epsilon);
+	CHECK(abs(scalar.xz - vectorized.xz) < epsilon);
+	CHECK(abs(scalar.yx - vectorized.yx) < epsilon);
+	CHECK(abs(scalar.yy - vectorized.yy) < epsilon);
+	CHECK(abs(scalar.yz - vectorized.yz) < epsilon);
+	CHECK(abs(scalar.zx - vectorized.zx) < epsilon);
+	CHECK(abs(scalar.zy - vectorized.zy) < epsilon);
+	CHECK(abs(scalar.zz - vectorized.zz) < epsilon);
+	CHECK(abs(scalar.target_squares - vectorized.target_squares) < epsilon);
+	CHECK(abs(scalar.moved_squares - vectorized.moved_squares) < epsilon);
+}
+
+TEST_CASE("[Modules][QCP] Single precision superposition stays close to the double path") {
+	// Seven headings per effector for five effectors, with a count that is not a multiple of the float lane width.
+	const uint32_t count = 7 * 5;
+	Quaternion expected_rotation = Quaternion(Vector3(0.3, 0.8, 0.1).normalized(), 0.7);
+	Vector3 expected_translation = Vector3(0.25, -1.5, 0.75);
+	Vector<Vector3> moved;
+	Vector<Vector3> target;
+	Vector<double> weight;
+	for (uint32_t i = 0; i < count; i++) {
+		Vector3 point = Vector3(Math::sin(i * 0.5), Math::cos(i * 0.3), i * 0.01);
+		moved.push_back(point);
+		target.push_back(expected_rotation.xform(point) + expected_translation);
+		weight.push_back(1.0 + (i % 3));
+	}
+
+	QCPSolver double_solver;
+	QCPSolver float_solver;
+	float_solver.set_scalar_precision(QCPSolver::SCALAR_PRECISION_FLOAT);
+	CHECK(float_solver.get_scalar_precision() == QCPSolver::SCALAR_PRECISION_FLOAT);
+	Quaternion double_rotation;
+	Quaternion float_rotation;
+	Vector3 double_translation;
+	Vector3 float_translation;
+	double_solver.weighted_superpose(moved.ptr(), target.ptr(), weight.ptr(), count, true, double_rotation, double_translation);
+	float_solver.weighted_superpose(moved.ptr(), target.ptr(), weight.ptr(), count, true, float_rotation, float_translation);
+
+	CHECK(double_rotation.angle_to(expected_rotation) < 1e-5);
+	CHECK(float_rotation.angle_to(double_rotation) < 1e-3);
+	CHECK(float_translation.distance_to(double_translation) < 1e-4);
+}
+
 } // namespace TestQCP
 
 #endif // TEST_QCP_H